@@ -0,0 +1,188 @@
+#include "MockChannelData.h"
+#include "MockResults.h"
+#include "MockSimulatedChannelDescriptor.h"
+#include "TestInstance.h"
+
+#include "MIPI_DSI_LP_Analyzer.h"
+#include "MIPI_DSI_LP_AnalyzerResults.h"
+#include "MIPI_DSI_LP_AnalyzerSettings.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace AnalyzerTest;
+
+// Decoder throughput of the MIPI DSI LP analyzer.
+//
+// Every workload is a capture made by the analyzer's own simulation, copied
+// into MockChannelData and decoded by the real WorkerThread(). Only the
+// decode is timed. Results go to stdout as a single JSON object.
+//
+// usage: MipiDsiLpBenchmarks [--samples N] [--repeat N]
+
+namespace {
+
+const U32 SampleRateHz = 50000000; // 50MHz, 25 samples per line state at 1Mbit/s
+
+struct Workload
+{
+    const char* name;
+    U32 longPackets;    // percent
+    U32 payloadLength;  // longest long packet payload, bytes
+    U32 idleGap;        // bit periods between bursts
+    U32 glitchRate;     // per mille of bursts
+};
+
+const Workload Workloads[] = {
+    // mostly stop state, an occasional short packet
+    { "idle_heavy",   10,  16, 2000,    0 },
+    // back to back short packets
+    { "short_storm",   0,   0,    1,    0 },
+    // 256 entry RGB888 lookup tables in long packets
+    { "lut_upload",  100, 768,    4,    0 },
+    // a glitch in every burst, so every packet ends in the error paths
+    { "glitch_heavy", 25,  64,   20, 1000 },
+};
+
+struct Result
+{
+    U64 samples = 0;
+    U64 edges = 0;
+    U64 packets = 0;
+    U64 bytes = 0;
+    double seconds = 0.0;
+};
+
+Channel PosChannel(0, 0, DIGITAL_CHANNEL);
+Channel NegChannel(0, 1, DIGITAL_CHANNEL);
+
+void SetupSettings(MIPI_DSI_LP_AnalyzerSettings* settings, const Workload& workload)
+{
+    settings->mPosChannel[0] = PosChannel;
+    settings->mNegChannel[0] = NegChannel;
+    settings->mMarkerDensity = MARKERS_PER_BIT;
+    settings->mFrameMode = FRAMES_PER_BYTE;
+    settings->mSimBitRate = 1000;
+    settings->mSimLongPackets = workload.longPackets;
+    settings->mSimPayloadLength = (workload.payloadLength > 0) ? workload.payloadLength : 1;
+    settings->mSimIdleGap = workload.idleGap;
+    settings->mSimSeed = 1;
+    settings->mSimFaultRate[SIM_FAULT_GLITCH] = workload.glitchRate;
+}
+
+// copies a simulated line into channel data, returns the number of edges
+U64 CopyChannel(SimulatedChannel* simulated, MockChannelData& data)
+{
+    U64 edges = 0;
+
+    simulated->ResetToStart();
+    data.TestSetInitialBitState(simulated->GetCurrentState());
+    while (simulated->AdvanceToNextTransition()) {
+        data.TestAppendTransitionAtSamples(simulated->GetCurrentSample());
+        ++edges;
+    }
+
+    // a little stop state after the last edge
+    data.TestAdvance(SampleRateHz / 1000);
+    data.ResetCurrentSample();
+    return edges;
+}
+
+Result RunWorkload(const Workload& workload, U64 samples)
+{
+    Result result;
+
+    // the capture comes from one instance's simulation...
+    Instance generator(::GetAnalyzerName());
+    SetupSettings(static_cast<MIPI_DSI_LP_AnalyzerSettings*>(generator.GetSettings()), workload);
+    generator.RunSimulation(samples, SampleRateHz);
+
+    // ...and is decoded by a fresh one
+    Instance plugin(::GetAnalyzerName());
+    auto settings = static_cast<MIPI_DSI_LP_AnalyzerSettings*>(plugin.GetSettings());
+    SetupSettings(settings, workload);
+
+    MockChannelData pos(&plugin);
+    MockChannelData neg(&plugin);
+    result.edges = CopyChannel(generator.GetSimulationChannel(PosChannel), pos);
+    result.edges += CopyChannel(generator.GetSimulationChannel(NegChannel), neg);
+    result.samples = generator.GetSimulationChannel(PosChannel)->GetSampleCount();
+
+    plugin.SetChannelData(PosChannel, &pos);
+    plugin.SetChannelData(NegChannel, &neg);
+    plugin.SetSampleRate(SampleRateHz);
+
+    auto start = std::chrono::steady_clock::now();
+    plugin.RunAnalyzerWorker();
+    auto end = std::chrono::steady_clock::now();
+    result.seconds = std::chrono::duration<double>(end - start).count();
+
+    auto results = MockResultData::MockFromResults(plugin.GetResults());
+    for (U64 i = 0; i < results->TotalFrameCount(); ++i) {
+        if (FRAME_KIND(results->GetFrame(i).mType) == FRAME_TYPE_BYTE) {
+            ++result.bytes;
+        }
+    }
+    result.packets = results->TotalPacketCount();
+
+    return result;
+}
+
+double PerSecond(U64 count, double seconds)
+{
+    return (seconds > 0.0) ? (count / seconds) : 0.0;
+}
+
+} // of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    U64 samples = 100000000;
+    int repeat = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "--samples") == 0) && (i + 1 < argc)) {
+            samples = strtoull(argv[++i], nullptr, 0);
+        } else if ((strcmp(argv[i], "--repeat") == 0) && (i + 1 < argc)) {
+            repeat = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--samples N] [--repeat N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (repeat < 1) {
+        repeat = 1;
+    }
+
+    printf("{\n  \"sample_rate_hz\": %u,\n  \"repeat\": %d,\n  \"workloads\": [\n", SampleRateHz, repeat);
+
+    const size_t count = sizeof(Workloads) / sizeof(Workloads[0]);
+    for (size_t w = 0; w < count; ++w) {
+        // the fastest run is the one least disturbed by the rest of the system
+        Result best;
+        for (int r = 0; r < repeat; ++r) {
+            Result result = RunWorkload(Workloads[w], samples);
+            if ((r == 0) || (result.seconds < best.seconds)) {
+                best = result;
+            }
+        }
+
+        printf("    {\"name\": \"%s\", \"samples\": %llu, \"edges\": %llu, \"packets\": %llu, \"bytes\": %llu, "
+               "\"seconds\": %.6f, \"edges_per_s\": %.0f, \"packets_per_s\": %.0f, \"ns_per_byte\": %.3f}%s\n",
+               Workloads[w].name,
+               static_cast<unsigned long long>(best.samples),
+               static_cast<unsigned long long>(best.edges),
+               static_cast<unsigned long long>(best.packets),
+               static_cast<unsigned long long>(best.bytes),
+               best.seconds,
+               PerSecond(best.edges, best.seconds),
+               PerSecond(best.packets, best.seconds),
+               (best.bytes > 0) ? (best.seconds * 1e9 / best.bytes) : 0.0,
+               (w + 1 < count) ? "," : "");
+    }
+
+    printf("  ]\n}\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+#include "MockChannelData.h"
+#include "MockResults.h"
+#include "TestInstance.h"
+#include "TestMacros.h"
+
+#include "MIPI_DSI_LP_Analyzer.h"
+#include "MIPI_DSI_LP_AnalyzerResults.h"
+#include "MIPI_DSI_LP_AnalyzerSettings.h"
+#include "MIPI_DSI_LP_Packet.h"
+
+#include <vector>
+
+using namespace AnalyzerTest;
+
+// Decoder checks of the MIPI DSI LP analyzer on hand-built captures.
+
+namespace {
+
+const U32 SampleRateHz = 10000000; // 10MHz
+const U64 StateSamples = 10;       // samples per line state
+
+Channel PosChannel(0, 0, DIGITAL_CHANNEL);
+Channel NegChannel(0, 1, DIGITAL_CHANNEL);
+
+// line states, Dp in bit 1 and Dn in bit 0
+enum LineState { LP00 = 0, LP01 = 1, LP10 = 2, LP11 = 3 };
+
+// builds a single lane capture a line state at a time
+class Capture
+{
+public:
+    Capture(Instance* plugin) : mPos(plugin), mNeg(plugin)
+    {
+        mPos.TestSetInitialBitState(BIT_HIGH);
+        mNeg.TestSetInitialBitState(BIT_HIGH);
+        Go(LP11, 10 * StateSamples);
+    }
+
+    void Go(int state, U64 samples)
+    {
+        if ((state ^ mState) & 2) {
+            mPos.TestAppendTransitionAtSamples(mSample);
+        }
+        if ((state ^ mState) & 1) {
+            mNeg.TestAppendTransitionAtSamples(mSample);
+        }
+        mState = state;
+        mSample += samples;
+    }
+
+    // escape mode entry, then the entry command MSB first
+    void Entry(U8 command)
+    {
+        Go(LP11, 5 * StateSamples);
+        Go(LP10, StateSamples);
+        Go(LP00, StateSamples);
+        Go(LP01, StateSamples);
+        Go(LP00, StateSamples);
+        for (int i = 7; i >= 0; --i) {
+            Go(((command >> i) & 1) ? LP10 : LP01, StateSamples);
+            Go(LP00, StateSamples);
+        }
+    }
+
+    // spaced one hot bits, LSB first
+    void Byte(U8 value)
+    {
+        for (int i = 0; i < 8; ++i) {
+            Go(((value >> i) & 1) ? LP10 : LP01, StateSamples);
+            Go(LP00, StateSamples);
+        }
+    }
+
+    void Stop()
+    {
+        Go(LP10, StateSamples);
+        Go(LP11, 10 * StateSamples);
+    }
+
+    // a low power data transmission burst
+    void Burst(const std::vector<U8>& bytes)
+    {
+        Entry(0xE1);
+        for (U8 value : bytes) {
+            Byte(value);
+        }
+        Stop();
+    }
+
+    void Attach(Instance& plugin)
+    {
+        Go(LP11, 100 * StateSamples);
+        mPos.ResetCurrentSample();
+        mNeg.ResetCurrentSample();
+        plugin.SetChannelData(PosChannel, &mPos);
+        plugin.SetChannelData(NegChannel, &mNeg);
+        plugin.SetSampleRate(SampleRateHz);
+    }
+
+private:
+    MockChannelData mPos;
+    MockChannelData mNeg;
+    U64 mSample = 0;
+    int mState = LP11;
+};
+
+// appends a header with its ECC, damaged by the bits in flip
+void AppendHeader(std::vector<U8>& bytes, U32 header, U32 flip = 0)
+{
+    header |= U32(DSI_ComputeEcc(header)) << 24;
+    header ^= flip;
+    for (U32 i = 0; i < DSI_HEADER_LENGTH; ++i) {
+        bytes.push_back(U8(header >> (8U * i)));
+    }
+}
+
+} // of anonymous namespace
+
+// an uncorrectable header must not take the rest of the burst along with its word count
+void verifyEccErrorEndsPacket()
+{
+    Instance plugin(::GetAnalyzerName());
+    auto settings = static_cast<MIPI_DSI_LP_AnalyzerSettings*>(plugin.GetSettings());
+    settings->mPosChannel[0] = PosChannel;
+    settings->mNegChannel[0] = NegChannel;
+    settings->mFrameMode = FRAMES_PER_PACKET;
+
+    // generic long write of two bytes, two word count bits flipped on the way,
+    // then a DCS short write in the same burst
+    std::vector<U8> bytes;
+    const U8 payload[] = { 0x10, 0x20 };
+    U16 crc = DSI_UpdateCrc(DSI_CRC_INIT, payload, sizeof(payload));
+    AppendHeader(bytes, 0x000229, (1U << 17) | (1U << 21));
+    bytes.insert(bytes.end(), payload, payload + sizeof(payload));
+    bytes.push_back(U8(crc));
+    bytes.push_back(U8(crc >> 8));
+    AppendHeader(bytes, 0x001105);
+
+    Capture capture(&plugin);
+    capture.Burst(bytes);
+    capture.Attach(plugin);
+    plugin.RunAnalyzerWorker();
+
+    auto results = MockResultData::MockFromResults(plugin.GetResults());
+    bool damaged = false;
+    bool decoded = false;
+    for (U64 i = 0; i < results->TotalFrameCount(); ++i) {
+        const Frame& frame = results->GetFrame(i);
+        if (FRAME_KIND(frame.mType) != FRAME_TYPE_PACKET) {
+            continue;
+        }
+
+        U8 di = U8(frame.mData1);
+        if ((di == 0x29) && (frame.mFlags & PACKET_FLAG_ECC_ERROR)) {
+            // the header alone, not a packet cut short
+            U32 payloadLength = PACKET_PAYLOAD_LENGTH(frame.mData2);
+            TEST_VERIFY_EQ(payloadLength, 0U);
+            TEST_VERIFY(!(frame.mFlags & PACKET_FLAG_TRUNCATED));
+            damaged = true;
+        } else if ((U32(frame.mData1) & 0xFFFFFF) == 0x001105) {
+            TEST_VERIFY(!(frame.mFlags & (PACKET_FLAG_ECC_ERROR | PACKET_FLAG_TRUNCATED)));
+            decoded = true;
+        }
+    }
+
+    TEST_VERIFY(damaged);
+    TEST_VERIFY(decoded);
+}
+
+int main()
+{
+    verifyEccErrorEndsPacket();
+
+    std::cout << "all MIPI DSI LP tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
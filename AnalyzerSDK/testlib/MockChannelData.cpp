@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <exception>
 #include <cmath>
+#include <limits>
 
 // REMOVE ME
 #include <iostream>
@@ -32,6 +33,7 @@ void MockChannelData::TestSetInitialBitState(BitState bs)
     // insert a dummy sample before the real data, so that
     // the logic in AdvanceToSample is simpler
     mTransitions.push_back(0);
+    mCursor = 0;
 }
 
 void MockChannelData::TestAppendTransitionAfterSamples(U64 sampleCount)
@@ -46,6 +48,7 @@ void MockChannelData::TestAppendTransitionAtSamples(U64 sample)
     mTransitions.push_back(sample);
     mCurrentSample = mTransitions.back();
     mCurrentState = InvertBitState(mCurrentState);
+    mCursor = mTransitions.size() - 1;
 }
 
 void MockChannelData::TestAppendTransitions(const std::vector<U64> &transitions)
@@ -65,6 +68,7 @@ double MockChannelData::TestAppendClockedState(U64 sampleRateHz, double currentE
             mTransitions.push_back(mCurrentSample);
         }
         mCurrentState = InvertBitState(mCurrentState);
+        mCursor = mTransitions.size() - 1;
     }
 
     return TestAdvanceTime(sampleRateHz, currentError, clockPeriodSec);
@@ -90,6 +94,7 @@ void MockChannelData::TestTransitionToState(BitState bs)
     }
     mTransitions.push_back(mCurrentSample);
     mCurrentState = bs;
+    mCursor = mTransitions.size() - 1;
 }
 
 void MockChannelData::TestAdvance(U32 samples)
@@ -107,47 +112,58 @@ void MockChannelData::ResetCurrentSample(U64 sampleNumber)
 {
     mCurrentState = mInitialState;
     mCurrentSample = 0;
+    mCursor = 0;
     AdvanceToSample(sampleNumber);
 }
 
+void MockChannelData::TestSetSampleCount(U64 sampleCount)
+{
+    mSampleCount = sampleCount;
+}
+
 U32 MockChannelData::AdvanceToSample(U64 sample)
 {
     assert(sample >= mCurrentSample);
     if (sample == mCurrentSample)
         return 0;
 
-    auto cur = std::upper_bound(mTransitions.begin(), mTransitions.end(), mCurrentSample) - 1;
-    if (cur == mTransitions.end()) {
-        throw OutOfDataException();
-    }
-
-    assert (*cur <= mCurrentSample);
-
-    auto it = std::upper_bound(mTransitions.begin(), mTransitions.end(), sample) - 1;
-    if (it == mTransitions.end()) {
+    if (mTransitions.empty()) {
         throw OutOfDataException();
     }
 
-    assert (*it <= sample);
-
-    if (it == cur) {
-        // no transitions between current and requested sample
-        // short circuit to avoud complicating the logic below
-        mCurrentSample = sample;
-        return 0;
-    }
+    const size_t next = SeekTransition(sample);
+    assert (mTransitions[next] <= sample);
 
-    // count the distance between the two
-    U32 transitionCount = std::distance(cur, it);
+    // count the transitions passed on the way
+    U32 transitionCount = next - mCursor;
     bool oddTransitionCount = transitionCount % 2;
     if (oddTransitionCount) {
         mCurrentState = InvertBitState(mCurrentState);
     }
 
+    mCursor = next;
     mCurrentSample = sample;
     return transitionCount;
 }
 
+size_t MockChannelData::SeekTransition(U64 sample) const
+{
+    // forward moves are mostly short, so walk a few transitions first
+    size_t index = mCursor;
+    const size_t linearEnd = std::min(mTransitions.size(), mCursor + 1 + LinearSeekLimit);
+    while ((index + 1 < linearEnd) && (mTransitions[index + 1] <= sample)) {
+        ++index;
+    }
+
+    if ((index + 1 < linearEnd) || (linearEnd == mTransitions.size())) {
+        return index;
+    }
+
+    // long jump: binary search what's left
+    auto it = std::upper_bound(mTransitions.begin() + linearEnd, mTransitions.end(), sample);
+    return (it - mTransitions.begin()) - 1;
+}
+
 double MockChannelData::InnerAppendIntervals(U64 sampleRateHz, double startingError, const std::vector<double> &intervals)
 {
     // same logic as built-in ClockGenerator, track accumulated error to ensure
@@ -246,25 +262,46 @@ void AnalyzerChannelData::AdvanceToNextEdge()
  //   std::cerr << "AdvNE: advanced to " << nextEdge << " from " << d->mCurrentSample << std::endl;
     d->mCurrentState = AnalyzerTest::InvertBitState(d->mCurrentState);
     d->mCurrentSample = nextEdge;
+    ++d->mCursor;
 }
 
 U64 AnalyzerChannelData::GetSampleOfNextEdge()
 {
     D_PTR();
-    auto next = std::lower_bound(d->mTransitions.begin(), d->mTransitions.end(), d->mCurrentSample);
-    if (next == d->mTransitions.end()) {
+    // the cursor is on the last transition at or before the current sample
+    const size_t next = d->mCursor + 1;
+    if (next >= d->mTransitions.size()) {
         throw AnalyzerTest::OutOfDataException();
     }
 
-    if (*next == d->mCurrentSample) {
-        // if we're exactly on the sample, advance
-        ++next;
-        if (next == d->mTransitions.end()) {
-            throw AnalyzerTest::OutOfDataException();
+    return d->mTransitions[next];
+}
+
+bool AnalyzerChannelData::DoMoreTransitionsExistInCurrentData()
+{
+    D_PTR();
+    // all of the mock's data is current, it never waits
+    return (d->mCursor + 1 < d->mTransitions.size());
+}
+
+void AnalyzerChannelData::TrackMinimumPulseWidth()
+{
+    // nothing to do, the mock has all transitions to hand
+}
+
+U64 AnalyzerChannelData::GetMinimumPulseWidthSoFar()
+{
+    D_PTR();
+    // shortest pulse ending at or before the current sample, 0 if there is none yet.
+    // mTransitions[0] is the dummy start entry, not an edge
+    U64 minimum = 0;
+    for (size_t i = 2; i <= d->mCursor; ++i) {
+        U64 width = d->mTransitions[i] - d->mTransitions[i - 1];
+        if ((minimum == 0) || (width < minimum)) {
+            minimum = width;
         }
     }
-
-    return *next;
+    return minimum;
 }
 
 bool AnalyzerChannelData::WouldAdvancingCauseTransition(U32 num_samples)
@@ -276,17 +313,14 @@ bool AnalyzerChannelData::WouldAdvancingCauseTransition(U32 num_samples)
 bool AnalyzerChannelData::WouldAdvancingToAbsPositionCauseTransition(U64 sample_number)
 {
     D_PTR();
-    auto next = std::lower_bound(d->mTransitions.begin(), d->mTransitions.end(), d->mCurrentSample);
-    if (next == d->mTransitions.end()) {
-        return false;
+    const size_t next = d->mCursor + 1;
+    if ((next < d->mTransitions.size()) && (d->mTransitions[next] <= sample_number)) {
+        return true;
     }
 
-    if (*next == d->mCurrentSample) {
-        ++next;
-        if (next == d->mTransitions.end()) {
-            return false;
-        }
+    // no edge this side of the end of the capture, waiting for one past it never ends
+    if (sample_number >= d->mSampleCount) {
+        throw AnalyzerTest::OutOfDataException();
     }
-
-    return (*next <= sample_number);
+    return false;
 }
@@ -2,6 +2,7 @@
 #define ANALYZER_TEST_MOCK_CHANNEL_DATA
 
 #include <exception>
+#include <limits>
 
 #include "AnalyzerChannelData.h"
 #include "TestInstance.h"
@@ -62,6 +63,10 @@ public:
 
     void ResetCurrentSample(U64 sampleNumber = 0);
 
+    // the capture ends after sampleCount samples: asking past the end throws
+    // OutOfDataException, where Logic would wait for data that never comes
+    void TestSetSampleCount(U64 sampleCount);
+
     U32 AdvanceToSample(U64 sample); // returns number of times the value changed
 
     void DumpTestData(double sampleRateMhz);
@@ -94,14 +99,29 @@ private:
      */
     void CheckForCancellation() const;
 
+    /**
+     * @brief SeekTransition - index of the last transition at or before
+     * sample, searching forward from the cursor: a short linear walk first,
+     * binary search for long jumps
+     */
+    size_t SeekTransition(U64 sample) const;
+
+    // transitions walked one by one before falling back to binary search
+    static const size_t LinearSeekLimit = 8;
+
     BitState mCurrentState = BIT_LOW;
     U64 mCurrentSample = 0;
+    // index of the last transition at or before mCurrentSample
+    size_t mCursor = 0;
 
     BitState mInitialState = BIT_LOW
             ;
     // absolute sample numbers of transitions
     std::vector<U64> mTransitions;
 
+    // samples in the capture, no end unless the test sets one
+    U64 mSampleCount = std::numeric_limits<U64>::max();
+
     const Instance* mInstance = nullptr;
 };
 
@@ -57,6 +57,28 @@ U64 AnalyzerResults::GetPacketContainingFrameSequential(U64 frame_id)
     return 0;
 }
 
+void AnalyzerResults::GetFramesContainedInPacket(U64 packet_id, U64* first_frame_id, U64* last_frame_id)
+{
+    D_PTR();
+    auto range = d->GetFrameRangeForPacket(packet_id);
+    *first_frame_id = range.first;
+    *last_frame_id = range.second;
+}
+
+void AnalyzerResults::AddPacketToTransaction(U64 transaction_id, U64 packet_id)
+{
+    D_PTR();
+    d->mTransactions[transaction_id].push_back(packet_id);
+}
+
+void AnalyzerResults::GetPacketsContainedInTransaction(U64 transaction_id, U64** packet_id_array, U64* packet_id_count)
+{
+    D_PTR();
+    auto& packets = d->mTransactions[transaction_id];
+    *packet_id_array = packets.data();
+    *packet_id_count = packets.size();
+}
+
 U64 AnalyzerResults::GetNumFrames()
 {
     D_PTR();
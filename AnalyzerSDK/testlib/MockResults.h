@@ -2,6 +2,8 @@
 #define ANALYZER_TEST_MOCK_RESULTS
 
 #include <iostream>
+#include <map>
+#include <vector>
 
 #include "AnalyzerResults.h"
 
@@ -65,6 +67,7 @@ private:
     std::vector<MarkerInfo> mMarkers;
     std::vector<StringInfo> mStrings;
     std::vector<std::string> mTabularText;
+    std::map<U64, std::vector<U64>> mTransactions; // packet ids, by transaction id
 
     bool mCancelled = false;
 };
@@ -1,5 +1,7 @@
 #include "MockSimulatedChannelDescriptor.h"
 
+#include <cassert>
+
 namespace {
     class DataExtractor : public SimulationChannelDescriptor {
     public:
@@ -57,7 +59,7 @@ double SimulatedChannel::GetDurationToNextTransition() const
 
 bool SimulatedChannel::AdvanceToNextTransition()
 {
-    if (mTransitionIndex >= (mTransitions.size() - 1)) {
+    if (mTransitionIndex >= mTransitions.size()) {
         return false;
     }
 
@@ -101,6 +103,9 @@ SimulationChannelDescriptor::SimulationChannelDescriptor(const SimulationChannel
     d->mChannel = otherD->mChannel;
     d->mSampleRateHz = otherD->mSampleRateHz;
     d->mInitialBitState = otherD->mInitialBitState;
+    d->mCurrentState = otherD->mCurrentState;
+    d->mCurrentSample = otherD->mCurrentSample;
+    d->mTransitions = otherD->mTransitions;
 }
 
 SimulationChannelDescriptor::~SimulationChannelDescriptor()
@@ -158,7 +163,7 @@ void SimulationChannelDescriptor::Advance(U32 num_samples_to_advance)
 BitState SimulationChannelDescriptor::GetCurrentBitState()
 {
     D_PTR();
-    return BIT_LOW;
+    return d->mCurrentState;
 }
 
 U64 SimulationChannelDescriptor::GetCurrentSampleNumber()
@@ -176,6 +181,8 @@ U64 SimulationChannelDescriptor::GetCurrentSampleNumber()
 SimulationChannelDescriptorGroup::SimulationChannelDescriptorGroup()
 {
     auto d = new AnalyzerTest::SimulatedChannelGroup();
+    // Add() hands out pointers into the vector, so it must never reallocate
+    d->mChannels.reserve(AnalyzerTest::SimulatedChannelGroup::MaxChannels);
     mData = reinterpret_cast<struct SimulationChannelDescriptorGroupData*>(d);
 }
 
@@ -188,6 +195,7 @@ SimulationChannelDescriptorGroup::~SimulationChannelDescriptorGroup()
 SimulationChannelDescriptor *SimulationChannelDescriptorGroup::Add(Channel &channel, U32 sample_rate, BitState intial_bit_state)
 {
     D_PTR();
+    assert(d->mChannels.size() < AnalyzerTest::SimulatedChannelGroup::MaxChannels);
     SimulationChannelDescriptor simChan;
     simChan.SetChannel(channel);
     simChan.SetInitialBitState(intial_bit_state);
@@ -198,7 +206,10 @@ SimulationChannelDescriptor *SimulationChannelDescriptorGroup::Add(Channel &chan
 
 void SimulationChannelDescriptorGroup::AdvanceAll(U32 num_samples_to_advance)
 {
-    // implement me
+    D_PTR();
+    for (auto& channel : d->mChannels) {
+        channel.Advance(num_samples_to_advance);
+    }
 }
 
 SimulationChannelDescriptor *SimulationChannelDescriptorGroup::GetArray()
@@ -3,6 +3,8 @@
 
 #include "SimulationChannelDescriptor.h"
 
+#include <vector>
+
 namespace AnalyzerTest
 {
 
@@ -48,6 +50,8 @@ class SimulatedChannelGroup
 public:
     SimulatedChannelGroup();
 
+    static const size_t MaxChannels = 16;
+
  private:
     friend ::SimulationChannelDescriptorGroup;
 
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <stdexcept>
 
 #include "MockSettings.h"
 
@@ -90,10 +90,85 @@ void verifyMockChannelData2()
 
 }
 
+void verifyMockChannelDataLongJumps()
+{
+    Instance plugin;
+
+    // an edge every 10 samples, starting low
+    MockChannelData channelData(&plugin);
+    channelData.TestSetInitialBitState(BIT_LOW);
+    for (int i = 0; i < 1000; ++i) {
+        channelData.TestAppendTransitionAfterSamples(10);
+    }
+    channelData.TestAdvance(10);
+
+    channelData.ResetCurrentSample();
+
+    // short steps are walked, long jumps are searched: both must agree
+    U32 transitions = channelData.AdvanceToSample(25);
+    TEST_VERIFY_EQ(transitions, 2);
+    TEST_VERIFY_EQ(channelData.GetBitState(), BIT_LOW);
+    TEST_VERIFY_EQ(channelData.GetSampleOfNextEdge(), 30);
+
+    transitions = channelData.AdvanceToSample(5030);
+    TEST_VERIFY_EQ(transitions, 501);
+    TEST_VERIFY_EQ(channelData.GetBitState(), BIT_HIGH);
+    TEST_VERIFY_EQ(channelData.GetSampleOfNextEdge(), 5040);
+
+    TEST_VERIFY(channelData.WouldAdvancingToAbsPositionCauseTransition(5039) == false);
+    TEST_VERIFY(channelData.WouldAdvancingToAbsPositionCauseTransition(5040) == true);
+
+    channelData.AdvanceToNextEdge();
+    TEST_VERIFY_EQ(channelData.GetSampleNumber(), 5040);
+    TEST_VERIFY_EQ(channelData.GetBitState(), BIT_LOW);
+    transitions = channelData.Advance(90);
+    TEST_VERIFY_EQ(transitions, 9);
+    TEST_VERIFY_EQ(channelData.GetBitState(), BIT_HIGH);
+
+    // past the last edge, nothing more to find
+    transitions = channelData.AdvanceToSample(10005);
+    TEST_VERIFY_EQ(transitions, 487);
+    TEST_VERIFY(channelData.DoMoreTransitionsExistInCurrentData() == false);
+
+    channelData.ResetCurrentSample(15);
+    TEST_VERIFY_EQ(channelData.GetBitState(), BIT_HIGH);
+    TEST_VERIFY_EQ(channelData.GetSampleOfNextEdge(), 20);
+}
+
+void verifyMockChannelDataSampleCount()
+{
+    Instance plugin;
+
+    MockChannelData channelData(&plugin);
+    channelData.TestSetInitialBitState(BIT_LOW);
+    channelData.TestAppendTransitionAfterSamples(10);
+    channelData.TestAppendTransitionAfterSamples(10);
+    channelData.ResetCurrentSample();
+    channelData.TestSetSampleCount(100);
+
+    // inside the capture the quiet stretch after the last edge can be looked at
+    TEST_VERIFY(channelData.WouldAdvancingToAbsPositionCauseTransition(20) == true);
+    channelData.AdvanceToNextEdge();
+    channelData.AdvanceToNextEdge();
+    TEST_VERIFY(channelData.WouldAdvancingToAbsPositionCauseTransition(99) == false);
+    TEST_VERIFY(channelData.DoMoreTransitionsExistInCurrentData() == false);
+
+    // past its end there is nothing to wait for
+    bool outOfData = false;
+    try {
+        channelData.WouldAdvancingToAbsPositionCauseTransition(100);
+    } catch (OutOfDataException&) {
+        outOfData = true;
+    }
+    TEST_VERIFY(outOfData);
+}
+
 int main(int argc, char* argv[])
 {
     verifyMockChannelData();
     verifyMockChannelData2();
+    verifyMockChannelDataLongJumps();
+    verifyMockChannelDataSampleCount();
 
     std::cout << "test harness verified ok" << std::endl;
     return EXIT_SUCCESS;
@@ -91,17 +91,15 @@ auto Instance::RunAnalyzerWorker(int timeoutSec) -> RunResult
 void Instance::RunSimulation(U64 num_samples, U32 sample_rate_hz)
 {
     mSimulatedChannels.clear();
-    SimulationChannelDescriptor* channels[16];
+    SimulationChannelDescriptor* channels = nullptr;
 
     GetDataFromAnalyzer(mAnalyzerInstance.get())->simulationRateHz = sample_rate_hz;
 
-    U32 count = mAnalyzerInstance->GenerateSimulationData(num_samples, sample_rate_hz, channels);
-    if (count == 0) {
-        return;
+    // the analyzer hands back an array of descriptors, not an array of pointers
+    U32 count = mAnalyzerInstance->GenerateSimulationData(num_samples, sample_rate_hz, &channels);
+    for (U32 i = 0; i < count; ++i) {
+        mSimulatedChannels.push_back(channels + i);
     }
-
-    mSimulatedChannels.resize(count);
-    memcpy(mSimulatedChannels.data(), channels, count * sizeof(SimulationChannelDescriptor*));
 }
 
 SimulatedChannel *Instance::GetSimulationChannel(const Channel &chan)
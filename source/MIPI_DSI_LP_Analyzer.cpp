@@ -1,5 +1,6 @@
 #include "MIPI_DSI_LP_Analyzer.h"
 #include "MIPI_DSI_LP_AnalyzerSettings.h"
+#include "MIPI_DSI_LP_Packet.h"
 #include <AnalyzerChannelData.h>
 #include <fstream>
 #include <string>
@@ -25,9 +26,17 @@ void MIPI_DSI_LP_Analyzer::SetupResults()
 {
 	mResults.reset( new MIPI_DSI_LP_AnalyzerResults( this, mSettings.get() ) );
 	SetAnalyzerResults( mResults.get() );
-	mResults->AddChannelBubblesWillAppearOn( mSettings->mPosChannel );
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		if (mSettings->mPosChannel[i] != UNDEFINED_CHANNEL) {
+			mResults->AddChannelBubblesWillAppearOn( mSettings->mPosChannel[i] );
+		}
+	}
 }
 
+/* Results are committed every COMMIT_FRAME_INTERVAL frames or COMMIT_TIME_INTERVAL seconds of capture, whichever comes first. */
+#define COMMIT_FRAME_INTERVAL	256U
+#define COMMIT_TIME_INTERVAL	0.05
+
 #ifdef DEBUG
 	#define DEBUG_PRINTF(...)		{fprintf(pFile, __VA_ARGS__);fprintf(pFile, "\n");}
 #else
@@ -37,11 +46,32 @@ void MIPI_DSI_LP_Analyzer::SetupResults()
 void MIPI_DSI_LP_Analyzer::WorkerThread()
 {
 	mSampleRateHz = GetSampleRate();
-	sampleStart = 0;
-	pulseLength = 0;
 
-	mDataP = GetAnalyzerChannelData( mSettings->mPosChannel );
-	mDataN = GetAnalyzerChannelData( mSettings->mNegChannel );
+	/* Translate marker density into the set of marker types to place. */
+	switch (mSettings->mMarkerDensity) {
+	case MARKERS_PER_BIT:
+		mMarkerMask = (1U << AnalyzerResults::Start) | (1U << AnalyzerResults::Stop) | (1U << AnalyzerResults::DownArrow) |
+			(1U << AnalyzerResults::One) | (1U << AnalyzerResults::Zero) | (1U << AnalyzerResults::ErrorX);
+		break;
+	case MARKERS_PER_BYTE:
+		mMarkerMask = (1U << AnalyzerResults::Start) | (1U << AnalyzerResults::Stop) | (1U << AnalyzerResults::DownArrow) |
+			(1U << AnalyzerResults::Dot) | (1U << AnalyzerResults::ErrorX);
+		break;
+	case MARKERS_ERRORS_ONLY:
+		mMarkerMask = (1U << AnalyzerResults::ErrorX);
+		break;
+	default:
+		mMarkerMask = 0U;
+		break;
+	}
+
+	mCommitSample = 0;
+	mCommitSampleInterval = U64(mSampleRateHz * COMMIT_TIME_INTERVAL);
+	if (mCommitSampleInterval == 0) {
+		mCommitSampleInterval = 1;
+	}
+	mFramesSinceCommit = 0;
+	mResultsPending = false;
 
 #ifdef DEBUG
 	pFile = fopen("log.txt", "w");
@@ -49,18 +79,76 @@ void MIPI_DSI_LP_Analyzer::WorkerThread()
 
 	DEBUG_PRINTF("Log started.");
 
+	/* One decoder per enabled lane, each walking its two lines as one stream of LP line states. */
+	mLaneCount = 0;
+	mHeldGroups = 0;
+	mNextFrameSample = 0;
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		if (mSettings->mPosChannel[i] == UNDEFINED_CHANNEL) {
+			continue;
+		}
+
+		LaneDecoder& lane = mLanes[mLaneCount++];
+		lane.index = U8(i);
+		lane.pos = mSettings->mPosChannel[i];
+		lane.neg = mSettings->mNegChannel[i];
+		lane.dataP = GetAnalyzerChannelData(lane.pos);
+		lane.dataN = GetAnalyzerChannelData(lane.neg);
+		lane.dataP->TrackMinimumPulseWidth();
+		lane.dataN->TrackMinimumPulseWidth();
+		lane.cursor.Reset(lane.dataP, lane.dataN, mSettings->mGlitchFilter);
+		/* Bit timing is learned from the capture as it goes. */
+		lane.pulse.Reset(mSettings->mTimeoutRatio);
+		lane.lpState = (lane.cursor.GetState() == LP_11) ? LP_STATE_STOP : LP_STATE_IDLE;
+		lane.sampleStart = 0;
+		lane.packet.byteCount = 0;
+		lane.packet.payload.reserve(0xFFFF);
+		lane.frames.clear();
+		lane.held.clear();
+		lane.reverse = false;
+		lane.request = INVALID_RESULT_INDEX;
+	}
+
 	for ( ; ; )
 	{
-		DEBUG_PRINTF("Loop.");
-		CheckIfThreadShouldExit();
+		LineEvent event;
+		LaneDecoder* lane = NextLane();
+
+		/* Nothing buffered on any lane. */
+		if (lane == NULL) {
+			/* Several lanes: any of them may be next, so wait on all of them. */
+			if (mLaneCount > 1) {
+				WaitForLanes();
+				continue;
+			}
+			/* One lane: show everything decoded so far, then wait for its next edge. */
+			if (mResultsPending) {
+				FlushResults(mLanes[0].cursor.GetSampleNumber());
+			}
+			lane = &mLanes[0];
+		}
 
-		if (!GetStart()) {
-			mResults->CommitResults();
-			continue;
+		lane->cursor.Next(event);
+		DecodeEvent(*lane, event);
+		if (mHeldGroups > 0) {
+			ReleaseGroups();
+		}
+
+		/* Nothing to decode before the next stop state: jump straight to it. */
+		/* Several lanes are walked in step, so there each edge still goes through the decoder. */
+		if ((lane->lpState == LP_STATE_IDLE) && (mLaneCount == 1)) {
+			/* The skip may wait a long time for data, so don't hold results back. */
+			if (mResultsPending) {
+				FlushResults(event.sample);
+			}
+			lane->cursor.SkipToStop();
+			lane->lpState = LP_STATE_STOP;
 		}
 
-		if (GetBitstream() >= 8) {
-			GetData();
+		/* Between sequences: commit if due, and check for exit. */
+		if (lane->lpState == LP_STATE_STOP) {
+			UpdateResults(lane->cursor.GetSampleNumber());
+			CheckIfThreadShouldExit();
 		}
 	}
 
@@ -69,347 +157,647 @@ void MIPI_DSI_LP_Analyzer::WorkerThread()
 #endif
 }
 
-bool MIPI_DSI_LP_Analyzer::GetStart()
+LaneDecoder* MIPI_DSI_LP_Analyzer::NextLane()
 {
-	/* D+ and D- should be at the same sample here. */
-	{
-		/* If D+ is behind D-. */
-		if (mDataP->GetSampleNumber() < mDataN->GetSampleNumber()) {
-			/* Advance D+ to D-. */
-			mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-			return false;
+	for ( ; ; ) {
+		LaneDecoder* next = NULL;
+		U64 nextSample = 0;
+		bool earlier = false;
+
+		/* The lane with the earliest edge goes first, so lanes are decoded in capture order. */
+		for (U32 i = 0; i < mLaneCount; i++) {
+			U64 sample;
+			if (mLanes[i].cursor.GetNextSample(sample) && ((next == NULL) || (sample < nextSample))) {
+				next = &mLanes[i];
+				nextSample = sample;
+			}
+		}
+		if (next == NULL) {
+			return NULL;
 		}
-		/* If D- is behind D+. */
-		if (mDataN->GetSampleNumber() < mDataP->GetSampleNumber()) {
-			/* Advance D- to D+. */
-			mDataN->AdvanceToAbsPosition(mDataP->GetSampleNumber());
-			return false;
+
+		/* A lane with nothing buffered yet may still have an earlier edge: wait for the capture to get there on it too. */
+		for (U32 i = 0; i < mLaneCount; i++) {
+			if ((&mLanes[i] != next) && mLanes[i].cursor.WaitFor(nextSample)) {
+				earlier = true;
+			}
+		}
+		if (!earlier) {
+			return next;
 		}
 	}
+}
 
-	/* Both D+ and D- must be high for start condition. */
-	{
-		/* Check D+. */
-		if (mDataP->GetBitState() != BIT_HIGH) {
-			/* Advance D+. */
-			mDataP->AdvanceToNextEdge();
-			return false;
+void MIPI_DSI_LP_Analyzer::WaitForLanes()
+{
+	U64 sample = 0;
+
+	/* Step past the lane furthest ahead. Waiting on a single lane would hold the others up while it is quiet, in ULPS say. */
+	for (U32 i = 0; i < mLaneCount; i++) {
+		U64 horizon = mLanes[i].cursor.GetHorizon();
+		if (horizon > sample) {
+			sample = horizon;
 		}
-		/* Check D-. */
-		if (mDataN->GetBitState() != BIT_HIGH) {
-			/* Advance D-. */
-			mDataN->AdvanceToNextEdge();
-			return false;
+	}
+	sample += mCommitSampleInterval;
+
+	for (U32 i = 0; i < mLaneCount; i++) {
+		if (mLanes[i].cursor.WaitFor(sample)) {
+			break;
 		}
 	}
 
-	/* D+ and D- are both high now. For a start condition, D- should go low first. */
-	/* Check if D+ goes low first instead. */
-	if (mDataP->GetSampleOfNextEdge() <= mDataN->GetSampleOfNextEdge()) {
-		/* Advance D+. */
-		mDataP->AdvanceToNextEdge();
-		return false;
+	/* Quiet lanes let held frames go. */
+	if (mHeldGroups > 0) {
+		ReleaseGroups();
+	}
+	if (mResultsPending) {
+		FlushResults(mLanes[0].cursor.GetHorizon());
 	}
+	CheckIfThreadShouldExit();
+}
 
-	/* D- goes low first, advance to falling edge. */
-	mDataN->AdvanceToNextEdge();
-	/* Advance D+ to D-. */
-	mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
+U64 MIPI_DSI_LP_Analyzer::GetLaneHorizon(LaneDecoder& lane)
+{
+	/* The lane adds nothing that starts before this. */
+	U64 horizon = lane.cursor.GetHorizon();
 
-	/* D- is low, D+ is high, next transition should be D+ going low. */
-	/* Check if next transition is on D- instead. */
-	if (mDataN->GetSampleOfNextEdge() <= mDataP->GetSampleOfNextEdge()) {
-		/* Advance D-. */
-		mDataN->AdvanceToNextEdge();
-		return false;
+	/* A sequence under way adds its frames from where it started. */
+	if ((lane.lpState >= LP_STATE_ESC_BRIDGE) && (lane.lpState != LP_STATE_HS_RQST) && (lane.sampleStart < horizon)) {
+		horizon = lane.sampleStart;
 	}
+	if (!lane.frames.empty() && (U64(lane.frames[0].mStartingSampleInclusive) < horizon)) {
+		horizon = U64(lane.frames[0].mStartingSampleInclusive);
+	}
+	return horizon;
+}
 
-	/* Advance D+ to falling edge. */
-	mDataP->AdvanceToNextEdge();
-	/* Advance D- to D+. */
-	mDataN->AdvanceToAbsPosition(mDataP->GetSampleNumber());
+/* What the decoder does on a line state change. */
+enum LpAction
+{
+	LP_ACTION_NONE = 0,
+	LP_ACTION_BRIDGE,		/* LP-10 -> LP-00: possible start. */
+	LP_ACTION_ACK,			/* LP-00 -> LP-01: entry pulse begins. */
+	LP_ACTION_ENTRY,		/* LP-01 -> LP-00: entry pulse ends, check timing. */
+	LP_ACTION_ENTRY_ERROR,	/* D+ went high during the entry pulse. */
+	LP_ACTION_MARK,			/* LP-00 -> LP-10 / LP-01: bit begins. */
+	LP_ACTION_BIT_1,		/* LP-10 -> LP-00: one bit. */
+	LP_ACTION_BIT_0,		/* LP-01 -> LP-00: zero bit. */
+	LP_ACTION_STOP,			/* LP-10 -> LP-11: stop. */
+	LP_ACTION_FAILED_STOP,	/* LP-01 -> LP-11: stop on the wrong line. */
+	LP_ACTION_BURST_ERROR,	/* Any other line state during a burst. */
+	LP_ACTION_TURNAROUND	/* LP-10 -> LP-11 after TA-Sure: the other side has the bus. */
+};
+
+struct LpTransition
+{
+	U8 next;	/* Next LpState. */
+	U8 action;	/* LpAction to run. */
+};
+
+/* Escape mode and bus turnaround protocol, indexed by current LpState and new LP line state (LP-00, LP-01, LP-10, LP-11). */
+static const LpTransition lpTransitions[LP_STATE_COUNT][4] =
+{
+	/* LP_STATE_IDLE */
+	{ { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_NONE } },
+	/* LP_STATE_STOP */
+	{ { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_HS_RQST, LP_ACTION_NONE }, { LP_STATE_ESC_RQST, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_NONE } },
+	/* LP_STATE_ESC_RQST */
+	{ { LP_STATE_ESC_BRIDGE, LP_ACTION_BRIDGE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_ESC_RQST, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_NONE } },
+	/* LP_STATE_ESC_BRIDGE */
+	{ { LP_STATE_ESC_BRIDGE, LP_ACTION_NONE }, { LP_STATE_ESC_ACK, LP_ACTION_ACK }, { LP_STATE_TA_GO, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_NONE } },
+	/* LP_STATE_ESC_ACK */
+	{ { LP_STATE_SPACE, LP_ACTION_ENTRY }, { LP_STATE_ESC_ACK, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_ENTRY_ERROR } },
+	/* LP_STATE_SPACE */
+	{ { LP_STATE_SPACE, LP_ACTION_NONE }, { LP_STATE_MARK_0, LP_ACTION_MARK }, { LP_STATE_MARK_1, LP_ACTION_MARK }, { LP_STATE_STOP, LP_ACTION_BURST_ERROR } },
+	/* LP_STATE_MARK_1 */
+	{ { LP_STATE_SPACE, LP_ACTION_BIT_1 }, { LP_STATE_IDLE, LP_ACTION_BURST_ERROR }, { LP_STATE_MARK_1, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_STOP } },
+	/* LP_STATE_MARK_0 */
+	{ { LP_STATE_SPACE, LP_ACTION_BIT_0 }, { LP_STATE_MARK_0, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_BURST_ERROR }, { LP_STATE_STOP, LP_ACTION_FAILED_STOP } },
+	/* LP_STATE_HS_RQST: LP-00 starts the HS burst, which is skipped like idle. */
+	{ { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_HS_RQST, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_NONE } },
+	/* LP_STATE_TA_GO */
+	{ { LP_STATE_TA_SURE, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_TA_GO, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_NONE } },
+	/* LP_STATE_TA_SURE */
+	{ { LP_STATE_TA_SURE, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_TA_GET, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_NONE } },
+	/* LP_STATE_TA_GET */
+	{ { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_IDLE, LP_ACTION_NONE }, { LP_STATE_TA_GET, LP_ACTION_NONE }, { LP_STATE_STOP, LP_ACTION_TURNAROUND } }
+};
+
+void MIPI_DSI_LP_Analyzer::DecodeEvent(LaneDecoder& lane, const LineEvent& event)
+{
+	const LpTransition& transition = lpTransitions[lane.lpState][event.state];
+	Bit bit;
+
+	lane.lpState = transition.next;
+
+	switch (transition.action) {
+	case LP_ACTION_NONE:
+		break;
+
+	case LP_ACTION_BRIDGE:
+		/* Remember this position as possible start. */
+		lane.sampleStart = event.sample;
+		DEBUG_PRINTF("Possible start detected. lane.sampleStart = %lld", lane.sampleStart);
+		break;
+
+	case LP_ACTION_ACK:
+		/* Length from start to pulse. */
+		lane.startToPulse = event.duration;
+		break;
+
+	case LP_ACTION_ENTRY:
+		/* First entry: the shortest D- pulse so far caps the guess, in case this entry pulse was stretched. */
+		/* A pulse under half the entry pulse is a glitch, not a bit, and must not seed the estimate. */
+		if (!lane.pulse.IsSeeded()) {
+			U64 minimum = lane.dataN->GetMinimumPulseWidthSoFar();
+			bool plausible = (minimum > 0) && (minimum < event.duration) && (minimum >= (event.duration >> 1));
+			lane.pulse.Seed(plausible ? minimum : event.duration);
+		}
+		/* The D- entry pulse is one pulse length. */
+		lane.pulse.Add(event.duration);
+		DEBUG_PRINTF("pulseLength = %lld", lane.pulse.GetLength());
+
+		/* Check if edge timings are outside boundary. */
+		if (lane.startToPulse > lane.pulse.GetTimeout()) {
+			DEBUG_PRINTF("Error: D- pulse timing outside boundary.");
+			AddMarker(lane.sampleStart, AnalyzerResults::ErrorX, lane.neg);
+			lane.lpState = LP_STATE_IDLE;
+			break;
+		}
+
+		/* Timings are ok: this is a start. */
+		DEBUG_PRINTF("Start is OK.");
+		AddMarker(lane.sampleStart, AnalyzerResults::Start, lane.pos);
+		/* Mark D- falling edge. */
+		AddMarker(event.sample, AnalyzerResults::DownArrow, lane.neg);
+
+		/* Start a new burst: its first byte is the entry command. */
+		lane.bytes.value = 0;
+		lane.bytes.bitCount = 0;
+		lane.escapeCommand = DSI_ESC_PENDING;
+		break;
 
-	/* D+ and D- are both low now. Next transition should be on D-. */
-	/* Check if next transition is on D+ instead. */
-	if (mDataP->GetSampleOfNextEdge() <= mDataN->GetSampleOfNextEdge()) {
-		/* Advance D+. */
-		mDataP->AdvanceToNextEdge();
-		return false;
+	case LP_ACTION_ENTRY_ERROR:
+		DEBUG_PRINTF("Error: D+ was not low during D- pulse.");
+		AddMarker(event.sample, AnalyzerResults::ErrorX, lane.neg);
+		break;
+
+	case LP_ACTION_MARK:
+		/* Check if the bit started too late. */
+		if (event.duration >= lane.pulse.GetTimeout()) {
+			DEBUG_PRINTF("Error: next edge too far.");
+			AddMarker(event.sample, AnalyzerResults::ErrorX, (event.state == LP_10) ? lane.pos : lane.neg);
+			EndBurst(lane);
+			lane.lpState = LP_STATE_IDLE;
+			break;
+		}
+		lane.pulse.Add(event.duration);
+		lane.markBegin = event.sample;
+		break;
+
+	case LP_ACTION_BIT_1:
+	case LP_ACTION_BIT_0:
+		bit.sampleBegin = lane.markBegin;
+		bit.sampleEnd = event.sample;
+		bit.value = (transition.action == LP_ACTION_BIT_1) ? BIT_HIGH : BIT_LOW;
+
+		/* Check if the bit lasted too long. */
+		if (event.duration >= lane.pulse.GetTimeout()) {
+			DEBUG_PRINTF("Error: bit too long.");
+			AddMarker(bit.sampleBegin, AnalyzerResults::ErrorX, (bit.value == BIT_HIGH) ? lane.pos : lane.neg);
+			EndBurst(lane);
+			lane.lpState = LP_STATE_IDLE;
+			break;
+		}
+		lane.pulse.Add(event.duration);
+
+		/* Mark the bit in the middle. */
+		if (bit.value == BIT_HIGH) {
+			AddMarker((bit.sampleBegin >> 1) + (bit.sampleEnd >> 1), AnalyzerResults::One, lane.pos);
+		} else {
+			AddMarker((bit.sampleBegin >> 1) + (bit.sampleEnd >> 1), AnalyzerResults::Zero, lane.neg);
+		}
+		/* Fold the bit into the current byte. */
+		AddBit(lane, bit);
+		break;
+
+	case LP_ACTION_STOP:
+		/* D+ went high first, then D-: this is stop. */
+		DEBUG_PRINTF("Stop condition @ %lld", lane.markBegin);
+		AddMarker(lane.markBegin, AnalyzerResults::Stop, lane.pos);
+		EndBurst(lane);
+		break;
+
+	case LP_ACTION_FAILED_STOP:
+		/* Stop occurs with D+ going high first, this one started on D-. */
+		DEBUG_PRINTF("Failed Stop condition on D- @ %lld", lane.markBegin);
+		AddMarker(lane.markBegin, AnalyzerResults::ErrorX, lane.neg);
+		EndBurst(lane);
+		break;
+
+	case LP_ACTION_BURST_ERROR:
+		/* D+ and D- should take turns, never change together. */
+		DEBUG_PRINTF("Error: unexpected line state %d @ %lld", event.state, event.sample);
+		AddMarker(event.sample, AnalyzerResults::ErrorX, lane.pos);
+		EndBurst(lane);
+		break;
+
+	case LP_ACTION_TURNAROUND:
+		AddTurnaround(lane, event.sample);
+		break;
 	}
+}
 
-	/* Remember this position as possible start. */
-	sampleStart = mDataP->GetSampleNumber();
-	DEBUG_PRINTF("Possible start detected. sampleStart = %lld", sampleStart);
+void MIPI_DSI_LP_Analyzer::AddTurnaround(LaneDecoder& lane, U64 sample)
+{
+	/* The bus changes hands: host to peripheral, or back. */
+	lane.reverse = !lane.reverse;
+	DEBUG_PRINTF("Bus turnaround @ %lld, %s transmits", sample, lane.reverse ? "peripheral" : "host");
+	AddMarker(lane.sampleStart, AnalyzerResults::Start, lane.pos);
+	AddMarker(sample, AnalyzerResults::Stop, lane.pos);
 
-	/* Calculate length from start to pulse. */
-	U64 startToPulse = mDataN->GetSampleOfNextEdge() - sampleStart;
+	Frame frame;
+	frame.mStartingSampleInclusive = lane.sampleStart;
+	frame.mEndingSampleInclusive = sample;
+	frame.mData1 = 0;
+	frame.mData2 = 0;
+	frame.mFlags = 0;
+	frame.mType = FRAME_TYPE_TURNAROUND;
+	AddFrame(lane, frame);
+	/* Keep it out of the next packet. */
+	EndGroup(lane, frame.mType);
+}
 
-	/* Go to D- rising edge. */
-	mDataN->AdvanceToNextEdge();
+void MIPI_DSI_LP_Analyzer::EndBurst(LaneDecoder& lane)
+{
+	/* Any trailing bits that don't make up a full byte are dropped. */
+	/* A packet still open here was cut short by the end of the burst. */
+	if (lane.packet.byteCount > 0) {
+		ClosePacket(lane);
+	}
+}
 
-	/* Calculate bitrate lenght using D- pulse. */
-	pulseLength = mDataN->GetSampleOfNextEdge() - mDataN->GetSampleNumber();
+void MIPI_DSI_LP_Analyzer::AddBit(LaneDecoder& lane, const Bit& bit)
+{
+	/* Only LPDT carries data bytes, bits after any other entry command are dropped. */
+	if (lane.escapeCommand != DSI_ESC_LPDT) {
+		if (lane.escapeCommand == DSI_ESC_PENDING) {
+			AddEntryBit(lane, bit);
+		}
+		return;
+	}
 
-	DEBUG_PRINTF("pulseLength = %lld", pulseLength);
+	/* First bit of a byte marks its first sample. */
+	if (lane.bytes.bitCount == 0U) {
+		lane.bytes.sampleBegin = bit.sampleBegin;
+	}
 
-	/* Go to D- falling edge. */
-	mDataN->AdvanceToNextEdge();
+	/* Bits are sent LSB first. */
+	if (bit.value == BIT_HIGH) {
+		lane.bytes.value |= (1ULL << lane.bytes.bitCount);
+	}
 
-	/* Check if edge timings are outside boundary. */
-	if (startToPulse > (pulseLength * 5)) {
-		DEBUG_PRINTF("Error: D- pulse timing outside boundary.");
-		mResults->AddMarker(sampleStart, AnalyzerResults::ErrorX, mSettings->mNegChannel);
-		return false;
+	/* Wait until the byte is complete. */
+	if (++lane.bytes.bitCount < 8U) {
+		return;
 	}
 
-	/* Check if D+ was low during D- pulse. */
-	if (mDataP->WouldAdvancingToAbsPositionCauseTransition(mDataN->GetSampleNumber())) {
-		DEBUG_PRINTF("Error: D+ was not low during D- pulse.");
-		/* D+ was not low, that's an error. */
-		mResults->AddMarker(mDataN->GetSampleNumber(), AnalyzerResults::ErrorX, mSettings->mNegChannel);
-		/* Advance D+ to D-. */
-		mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-		return false;
+	/* The eighth bit closes the byte, hand it over right away. */
+	AddByte(lane, U8(lane.bytes.value), lane.bytes.sampleBegin, bit.sampleEnd);
+	/* Mark the byte boundary. */
+	AddMarker(bit.sampleEnd, AnalyzerResults::Dot, lane.pos);
+
+	/* Start the next byte. */
+	lane.bytes.value = 0;
+	lane.bytes.bitCount = 0;
+}
+
+void MIPI_DSI_LP_Analyzer::AddEntryBit(LaneDecoder& lane, const Bit& bit)
+{
+	if (lane.bytes.bitCount == 0U) {
+		lane.bytes.sampleBegin = bit.sampleBegin;
 	}
 
-	/* Timings are ok: this is a start. */
-	DEBUG_PRINTF("Start is OK.");
-	mResults->AddMarker(sampleStart, AnalyzerResults::Start, mSettings->mPosChannel);
+	/* Entry commands are listed first bit first, so it goes to the MSB. */
+	lane.bytes.value = (lane.bytes.value << 1) | ((bit.value == BIT_HIGH) ? 1U : 0U);
+
+	if (++lane.bytes.bitCount < 8U) {
+		return;
+	}
 
-	/* Advance D+ to D-. */
-	mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-	/* Mark D- falling edge. */
-	mResults->AddMarker(mDataN->GetSampleNumber(), AnalyzerResults::DownArrow, mSettings->mNegChannel);
+	U8 entry = U8(lane.bytes.value);
+	lane.escapeCommand = DSI_DecodeEscapeCommand(entry);
+	AddMarker(bit.sampleEnd, AnalyzerResults::Dot, lane.pos);
+	DEBUG_PRINTF("Entry command 0x%02X @ %lld", entry, lane.bytes.sampleBegin);
+
+	/* LPDT goes on to the packet decoder, anything else is a frame of its own. */
+	if (lane.escapeCommand != DSI_ESC_LPDT) {
+		Frame frame;
+		frame.mStartingSampleInclusive = lane.bytes.sampleBegin;
+		frame.mEndingSampleInclusive = bit.sampleEnd;
+		frame.mData1 = entry;
+		frame.mData2 = lane.escapeCommand;
+		frame.mFlags = (lane.escapeCommand == DSI_ESC_UNKNOWN) ? DISPLAY_AS_ERROR_FLAG : 0;
+		frame.mType = FRAME_TYPE_ESCAPE;
+		AddFrame(lane, frame);
+		/* Keep it out of the next packet. */
+		EndGroup(lane, frame.mType);
+	}
 
-	/* D+ and D- are at the falling edge sample of D- pulse here. */
-	return true;
+	lane.bytes.value = 0;
+	lane.bytes.bitCount = 0;
 }
 
-U64 MIPI_DSI_LP_Analyzer::GetBitstream()
+void MIPI_DSI_LP_Analyzer::AddByte(LaneDecoder& lane, U8 value, U64 sampleBegin, U64 sampleEnd)
 {
-	U64 bitCounter = 0xFFFF * 8; /* Max number of bits allowed. */
+	/* First byte of a packet. */
+	if (lane.packet.byteCount == 0U) {
+		lane.packet.sampleBegin = sampleBegin;
+		lane.packet.header = 0;
+		lane.packet.flags = 0;
+		lane.packet.length = DSI_HEADER_LENGTH;
+		lane.packet.crc = DSI_CRC_INIT;
+		lane.packet.crcBlockLength = 0;
+		lane.packet.payload.clear();
+
+		/* Nothing on the wire confirms a turnaround: after a missed one the direction stays wrong.
+		   A data type only the host sends puts it back; the ECC is the same both ways and can't tell. */
+		lane.packet.resync = lane.reverse && (DSI_GetDataTypeInfo(DSI_GetDataType(value), true).dtClass == DSI_DT_CLASS_UNKNOWN) &&
+			(DSI_GetDataTypeInfo(DSI_GetDataType(value), false).dtClass != DSI_DT_CLASS_UNKNOWN);
+		if (lane.packet.resync) {
+			DEBUG_PRINTF("Direction resync @ %lld, DI = 0x%02X is a host packet", sampleBegin, value);
+			lane.reverse = false;
+			lane.packet.flags = DISPLAY_AS_WARNING_FLAG;
+		}
+		lane.packet.dtClass = DSI_GetDataTypeInfo(DSI_GetDataType(value), lane.reverse).dtClass;
+	}
+	lane.packet.sampleEnd = sampleEnd;
+
+	U8 flags = 0;
+	U8 role;
+
+	/* Sort the byte into header, payload or checksum. */
+	if (lane.packet.byteCount < DSI_HEADER_LENGTH) {
+		lane.packet.header |= U64(value) << (8U * lane.packet.byteCount);
+		if (lane.packet.byteCount == 0U) {
+			role = BYTE_ROLE_DI;
+			flags = lane.packet.flags;
+		} else if (lane.packet.byteCount == (DSI_HEADER_LENGTH - 1)) {
+			role = BYTE_ROLE_ECC;
+		} else {
+			role = DSI_IsLongPacket(U8(lane.packet.header)) ? BYTE_ROLE_WORD_COUNT : BYTE_ROLE_DATA;
+		}
+	} else if (lane.packet.byteCount >= (lane.packet.length - DSI_FOOTER_LENGTH)) {
+		/* First checksum byte: fold in what's left of the payload. */
+		if (lane.packet.byteCount == (lane.packet.length - DSI_FOOTER_LENGTH)) {
+			lane.packet.crc = DSI_UpdateCrc(lane.packet.crc, lane.packet.crcBlock, lane.packet.crcBlockLength);
+			lane.packet.crcBlockLength = 0;
+		}
 
-	data.clear();
+		lane.packet.header |= U64(value) << (32U + 8U * (lane.packet.byteCount + DSI_FOOTER_LENGTH - lane.packet.length));
+		role = BYTE_ROLE_CHECKSUM;
 
-	/* Get bitstream. */
-	while (--bitCounter)
-	{
-		DEBUG_PRINTF("GetBitstream() loop. bit_counter = %lld, Dp = %lld , Dm = %lld", bitCounter, mDataP->GetSampleNumber(), mDataN->GetSampleNumber());
-
-		/* D+ and D- should be at the same sample here. */
-		{
-			/* If D+ is behind D-. */
-			if (mDataP->GetSampleNumber() < mDataN->GetSampleNumber()) {
-				/* Advance D+ to D-. */
-				mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-			}
-			/* If D- is behind D+. */
-			if (mDataN->GetSampleNumber() < mDataP->GetSampleNumber()) {
-				/* Advance D- to D+. */
-				mDataN->AdvanceToAbsPosition(mDataP->GetSampleNumber());
+		/* Last checksum byte: compare, unless the host didn't calculate one. */
+		if (lane.packet.byteCount == (lane.packet.length - 1)) {
+			U16 checksum = PACKET_CHECKSUM(lane.packet.header);
+			if ((checksum != DSI_CRC_NOT_CALCULATED) && (checksum != lane.packet.crc)) {
+				flags = PACKET_FLAG_CRC_ERROR | DISPLAY_AS_ERROR_FLAG;
+				lane.packet.flags |= flags;
 			}
 		}
+	} else {
+		/* Payload: the CRC takes it eight bytes at a time. */
+		role = BYTE_ROLE_PAYLOAD;
+		lane.packet.crcBlock[lane.packet.crcBlockLength++] = value;
+		if (lane.packet.crcBlockLength == sizeof(lane.packet.crcBlock)) {
+			lane.packet.crc = DSI_UpdateCrc(lane.packet.crc, lane.packet.crcBlock, lane.packet.crcBlockLength);
+			lane.packet.crcBlockLength = 0;
+		}
 
-		/* Both D+ and D- should be low here. */
-		{
-			/* Check if D+ high. */
-			if (mDataP->GetBitState() == BIT_HIGH) {
-				/* Add error marker. */
-				mResults->AddMarker(mDataP->GetSampleNumber(), AnalyzerResults::ErrorX, mSettings->mPosChannel);
-				break;
-			}
-			/* Check if D- is high. */
-			if (mDataN->GetBitState() == BIT_HIGH) {
-				/* Add error marker. */
-				mResults->AddMarker(mDataN->GetSampleNumber(), AnalyzerResults::ErrorX, mSettings->mNegChannel);
-				break;
-			}
+		if (mSettings->mFrameMode == FRAMES_PER_PACKET) {
+			lane.packet.payload.push_back(value);
 		}
+	}
 
-		/* Check on which data line we've got next edge. */
-		if (mDataP->GetSampleOfNextEdge() <= mDataN->GetSampleOfNextEdge()) {
-			/* Check if next edge is too far. */
-			if ((mDataP->GetSampleOfNextEdge() - mDataP->GetSampleNumber()) >= (pulseLength * 5)) {
-				DEBUG_PRINTF("Error: D+ too far.");
-				/* Go to rising edge. */
-				mDataP->AdvanceToNextEdge();
-				/* Add error marker. */
-				mResults->AddMarker(mDataP->GetSampleNumber(), AnalyzerResults::ErrorX, mSettings->mPosChannel);
-				/* Advance D- to D+. */
-				mDataN->AdvanceToAbsPosition(mDataP->GetSampleNumber());
-				/* Exit bitsteam. */
-				break;
-			}
+	if (lane.packet.byteCount == (DSI_HEADER_LENGTH - 1)) {
+		/* Header is in: check its ECC and fix a single-bit error before trusting WC. */
+		U32 header = U32(lane.packet.header);
+		switch (DSI_CheckEcc(header)) {
+		case DSI_ECC_CORRECTED:
+			flags = PACKET_FLAG_ECC_CORRECTED | DISPLAY_AS_WARNING_FLAG;
+			break;
+		case DSI_ECC_ERROR:
+			flags = PACKET_FLAG_ECC_ERROR | DISPLAY_AS_ERROR_FLAG;
+			break;
+		default:
+			break;
+		}
+		lane.packet.header = header;
+		lane.packet.flags |= flags;
+		/* The corrected DI may name another data type. */
+		lane.packet.dtClass = DSI_GetDataTypeInfo(DSI_GetDataType(header & 0xFF), lane.reverse).dtClass;
+
+		/* A long packet adds its word count and checksum. A header the ECC couldn't fix has no word count to trust:
+		   the packet ends with it, and the next byte starts a new one. */
+		if (DSI_IsLongPacket(header & 0xFF) && !(flags & PACKET_FLAG_ECC_ERROR)) {
+			lane.packet.length = DSI_HEADER_LENGTH + ((header >> 8) & 0xFFFF) + DSI_FOOTER_LENGTH;
+		}
+	}
 
-			/* Go to rising edge. */
-			mDataP->AdvanceToNextEdge();
-			/* Advance D- to D+. */
-			mDataN->AdvanceToAbsPosition(mDataP->GetSampleNumber());
-
-			/* If this is a bit on D+, there won't be any transitions on D- until D+ falling edge. */
-			/* Check if there's a transition on D- until D+ falling edge making it a stop condition. */
-			/* Check if there are no more transitions on D+ (so there won't be a falling edge) but there is a transition on D- making it a stop condition. */
-			if ((mDataN->GetSampleOfNextEdge() <= mDataP->GetSampleOfNextEdge()) || (!mDataP->DoMoreTransitionsExistInCurrentData() && mDataN->DoMoreTransitionsExistInCurrentData())) {
-				/* Advance D-. */
-				mDataN->AdvanceToNextEdge();
-				/* Both D+ and D- are high now, this is stop. */
-				DEBUG_PRINTF("Stop condition @ %lld / data.size() = %lli", mDataP->GetSampleNumber(), data.size());
-				mResults->AddMarker(mDataP->GetSampleNumber(), AnalyzerResults::Stop, mSettings->mPosChannel);
-				/* Exit bitsteam. */
-				DEBUG_PRINTF("Exit bitstream.");
-				break;
-			}
+	if (mSettings->mFrameMode == FRAMES_PER_BYTE) {
+		/* One frame per byte, describing itself: index and role within its packet, and the packet's DI.
+		   ECC and checksum bytes carry their verdicts. */
+		Frame frame;
+		frame.mStartingSampleInclusive = sampleBegin;
+		frame.mEndingSampleInclusive = sampleEnd;
+		frame.mData1 = value;
+		frame.mData2 = BYTE_DATA2(lane.packet.byteCount, U8(lane.packet.header), role);
+		frame.mFlags = flags;
+		frame.mType = FRAME_TYPE_BYTE | FRAME_TYPE_CLASS(lane.packet.dtClass) | (lane.packet.resync ? FRAME_TYPE_RESYNC : 0);
+		AddFrame(lane, frame);
+	}
 
-			/* Bit's on D+. */
-			Bit bit;
-			DEBUG_PRINTF("D+ bit.");
-
-			/* Remember bit stats. */
-			bit.sampleBegin = mDataP->GetSampleNumber();
-			bit.sampleEnd = mDataP->GetSampleOfNextEdge();
-
-			/* Check if next edge is too far. */
-			if ((bit.sampleEnd - bit.sampleBegin) >= (pulseLength * 5)) {
-				DEBUG_PRINTF("Next edge too far.");
-				/* Mark an error at sample begin. */
-				mResults->AddMarker(bit.sampleBegin, AnalyzerResults::ErrorX, mSettings->mPosChannel);
-				/* Advance D+ over this long pulse (to bit.sampleEnd). */
-				mDataP->AdvanceToNextEdge();
-				/* Advance D-. */
-				mDataN->AdvanceToAbsPosition(mDataP->GetSampleNumber());
-				/* Exit bitsteam. */
-				break;
-			}
+	lane.packet.byteCount++;
+	if (lane.packet.byteCount == lane.packet.length) {
+		ClosePacket(lane);
+	}
+}
 
-			bit.value = BIT_HIGH;
-			/* Mark the bit in the middle. */
-			mResults->AddMarker((bit.sampleBegin >> 1) + (bit.sampleEnd >> 1), AnalyzerResults::One, mSettings->mPosChannel);
-
-			/* Go to falling edge (bit.sampleEnd). */
-			mDataP->AdvanceToNextEdge();
-			/* Save the bit. */
-			data.push_back(bit);
-			/* Advance D- to bit's end. */
-			mDataN->AdvanceToAbsPosition(mDataP->GetSampleNumber());
-		}
-		else {
-			/* Check if next edge is too far. */
-			if ((mDataN->GetSampleOfNextEdge() - mDataN->GetSampleNumber()) >= (pulseLength * 5)) {
-				DEBUG_PRINTF("Error: D- too far.");
-				/* Go to rising edge. */
-				mDataN->AdvanceToNextEdge();
-				/* Add error marker. */
-				mResults->AddMarker(mDataN->GetSampleNumber(), AnalyzerResults::ErrorX, mSettings->mNegChannel);
-				/* Advance D+ to D-. */
-				mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-				/* Exit bitsteam. */
-				break;
-			}
+void MIPI_DSI_LP_Analyzer::ClosePacket(LaneDecoder& lane)
+{
+	if (mSettings->mFrameMode == FRAMES_PER_PACKET) {
+		/* One frame for the whole packet. */
+		Frame frame;
+		frame.mStartingSampleInclusive = lane.packet.sampleBegin;
+		frame.mEndingSampleInclusive = lane.packet.sampleEnd;
+		frame.mData1 = lane.packet.header;
+		frame.mData2 = 0;
+		if (!lane.packet.payload.empty()) {
+			frame.mData2 = mResults->AddPayload(&lane.packet.payload[0], U32(lane.packet.payload.size())) | (U64(lane.packet.payload.size()) << 48U);
+		}
+		frame.mFlags = lane.packet.flags;
+		if (lane.packet.byteCount < lane.packet.length) {
+			frame.mFlags |= PACKET_FLAG_TRUNCATED | DISPLAY_AS_ERROR_FLAG;
+		}
+		/* An error outranks a warning. */
+		if (frame.mFlags & DISPLAY_AS_ERROR_FLAG) {
+			frame.mFlags &= ~DISPLAY_AS_WARNING_FLAG;
+		}
+		frame.mType = FRAME_TYPE_PACKET | FRAME_TYPE_CLASS(lane.packet.dtClass) | (lane.packet.resync ? FRAME_TYPE_RESYNC : 0);
+		AddFrame(lane, frame);
+	}
 
-			/* Go to rising edge. */
-			mDataN->AdvanceToNextEdge();
-			/* Advance D+ to D-. */
-			mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-
-			/* If this is a bit on D-, there won't be any transitions on D+ until D- falling edge. */
-			/* Check if there's a transition on D+ until D- falling edge making it a (failed) stop condition. */
-			/* Check if there are no more transitions on D- (so there won't be a falling edge) but there is a transition on D+ making it a (failed) stop condition. */
-			if ((mDataP->GetSampleOfNextEdge() <= mDataN->GetSampleOfNextEdge()) || (!mDataN->DoMoreTransitionsExistInCurrentData() && mDataP->DoMoreTransitionsExistInCurrentData())) {
-				/* Advance D+. */
-				mDataP->AdvanceToNextEdge();
-				/* Both D+ and D- are high now, this is failed stop (as stop occurs with D+ going high first). */
-				DEBUG_PRINTF("Failed Stop condition on D- @ %lld / data.size() = %lli", mDataP->GetSampleNumber(), data.size());
-				mResults->AddMarker(mDataN->GetSampleNumber(), AnalyzerResults::ErrorX, mSettings->mNegChannel);
-				/* Exit bitsteam. */
-				DEBUG_PRINTF("Exit bitstream.");
-				break;
-			}
+	/* Group the packet's frames. */
+	EndGroup(lane, FRAME_TYPE_PACKET | (lane.reverse ? FRAME_TYPE_REVERSE : 0));
+	lane.packet.byteCount = 0;
+}
 
-			/* Bit's on D-. */
-			Bit bit;
-			DEBUG_PRINTF("D- bit.");
-
-			/* Remember bit stats. */
-			bit.sampleBegin = mDataN->GetSampleNumber();
-			bit.sampleEnd = mDataN->GetSampleOfNextEdge();
-
-			/* Check if next edge is too far. */
-			if ((bit.sampleEnd - bit.sampleBegin) >= (pulseLength * 5)) {
-				DEBUG_PRINTF("Next edge too far.");
-				/* Mark an error at sample begin. */
-				mResults->AddMarker(bit.sampleBegin, AnalyzerResults::ErrorX, mSettings->mNegChannel);
-				/* Advance D- over this long pulse (to bit.sampleEnd). */
-				mDataN->AdvanceToNextEdge();
-				/* Advance D+. */
-				mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-				/* Exit bitsteam. */
-				break;
-			}
+void MIPI_DSI_LP_Analyzer::AddMarker(U64 sample, AnalyzerResults::MarkerType type, Channel& channel)
+{
+	/* Skip markers the marker density setting filters out. */
+	if (mMarkerMask & (1U << type)) {
+		mResults->AddMarker(sample, type, channel);
+		mResultsPending = true;
+	}
+}
+
+void MIPI_DSI_LP_Analyzer::AddFrame(LaneDecoder& lane, Frame& frame)
+{
+	frame.mFlags |= lane.index << FRAME_LANE_SHIFT;
+	/* The turnaround frame itself is tagged with the direction it hands over to. */
+	if (lane.reverse) {
+		frame.mType |= FRAME_TYPE_REVERSE;
+	}
 
-			bit.value = BIT_LOW;
-			/* Mark the bit in the middle. */
-			mResults->AddMarker((bit.sampleBegin >> 1) + (bit.sampleEnd >> 1), AnalyzerResults::Zero, mSettings->mNegChannel);
+	/* With several lanes, frames wait in their group: the lanes are decoded side by side, frames have to go in one after the other. */
+	if (mLaneCount > 1) {
+		lane.frames.push_back(frame);
+		return;
+	}
 
-			/* Go to falling edge (bit.sampleEnd). */
-			mDataN->AdvanceToNextEdge();
-			/* Save the bit. */
-			data.push_back(bit);
-			/* Advance D+ to bit's end. */
-			mDataP->AdvanceToAbsPosition(mDataN->GetSampleNumber());
-		}
+	AddFrame(frame);
+}
+
+void MIPI_DSI_LP_Analyzer::AddFrame(const Frame& frame)
+{
+	mResults->AddFrame(frame);
+	mFramesSinceCommit++;
+	mResultsPending = true;
+}
+
+void MIPI_DSI_LP_Analyzer::EndGroup(LaneDecoder& lane, U8 type)
+{
+	/* One lane: the frames are in already, in capture order. */
+	if (mLaneCount == 1) {
+		PairPacket(lane, type, mResults->CommitPacketAndStartNewPacket());
+		return;
 	}
 
-	mResults->CommitResults();
-	return data.size();
+	/* Several lanes: hold the group until no other lane can add anything that starts before it. */
+	lane.held.push_back(FrameGroup());
+	lane.held.back().type = type;
+	lane.held.back().frames.swap(lane.frames);
+	mHeldGroups++;
 }
 
-U64 MIPI_DSI_LP_Analyzer::GetData(void)
+void MIPI_DSI_LP_Analyzer::ReleaseGroups()
 {
-	Frame frame;
-	U64 byteIndex, byteCount;
+	for ( ; ; ) {
+		LaneDecoder* next = NULL;
+		U64 nextSample = 0;
+
+		/* The held group that starts first, the lower lane on a tie... */
+		for (U32 i = 0; i < mLaneCount; i++) {
+			if (!mLanes[i].held.empty()) {
+				const FrameGroup& group = mLanes[i].held.front();
+				U64 sample = group.frames.empty() ? 0 : U64(group.frames[0].mStartingSampleInclusive);
+				if ((next == NULL) || (sample < nextSample)) {
+					next = &mLanes[i];
+					nextSample = sample;
+				}
+			}
+		}
+		if (next == NULL) {
+			return;
+		}
 
-	/* Initialize frame's fields. */
-	frame.mStartingSampleInclusive = 0;
-	frame.mEndingSampleInclusive = 0;
-	frame.mData1 = 0;
-	frame.mData2 = 0;
-	frame.mFlags = 0;
-	frame.mType = 0;
+		/* ...goes in once every other lane is past its start. */
+		for (U32 i = 0; i < mLaneCount; i++) {
+			if ((&mLanes[i] != next) && (GetLaneHorizon(mLanes[i]) <= nextSample)) {
+				return;
+			}
+		}
 
-	/* Number of bytes in the stream. */
-	byteCount = data.size() / 8U;
-	byteIndex = 0U;
+		AddGroup(*next, next->held.front());
+		next->held.pop_front();
+		mHeldGroups--;
+	}
+}
 
-	/* Extract bitstream by 8 bits. */
-	while (data.size() >= 8)
-	{
-		DataBuilder byteBuilder;
-		U64 byte = 0;
+void MIPI_DSI_LP_Analyzer::AddGroup(LaneDecoder& lane, FrameGroup& group)
+{
+	/* Frames can't overlap. A group starting inside the last one added, like every lane entering ULPS together, keeps only its markers. */
+	if (group.frames.empty() || (U64(group.frames[0].mStartingSampleInclusive) < mNextFrameSample)) {
+		DEBUG_PRINTF("Lane %d frames @ %lld overlap the last ones added", lane.index, group.frames.empty() ? 0ULL : group.frames[0].mStartingSampleInclusive);
+		PairPacket(lane, group.type, INVALID_RESULT_INDEX);
+		return;
+	}
 
-		/* Mark first and last samples of a frame. */
-		frame.mStartingSampleInclusive = data.front().sampleBegin;
-		frame.mEndingSampleInclusive = data.at(7).sampleEnd;
+	for (size_t i = 0; i < group.frames.size(); i++) {
+		AddFrame(group.frames[i]);
+	}
+	mNextFrameSample = U64(group.frames.back().mEndingSampleInclusive) + 1;
+	PairPacket(lane, group.type, mResults->CommitPacketAndStartNewPacket());
+}
 
-		/* Reset byteBuilder onto byte. */
-		byteBuilder.Reset(&byte, AnalyzerEnums::LsbFirst, 8);
-		/* Loop through 8 bits of a data. */
-		for (int i = 0; i < 8; i++) byteBuilder.AddBit(data.at(i).value);
-		/* Remove those 8 bits. */
-		data.erase(data.begin(), data.begin() + 8);
+void MIPI_DSI_LP_Analyzer::PairPacket(LaneDecoder& lane, U8 type, U64 packetId)
+{
+	switch (FRAME_KIND(type)) {
+	case FRAME_TYPE_PACKET:
+		/* Pair what the peripheral sends back after a turnaround with the host packet before it.
+		   A resynced packet is no reply: it starts over as the host's next request. */
+		if (!(type & FRAME_TYPE_REVERSE)) {
+			lane.request = packetId;
+			lane.requestPaired = false;
+		} else if ((lane.request != INVALID_RESULT_INDEX) && (packetId != INVALID_RESULT_INDEX)) {
+			if (!lane.requestPaired) {
+				mResults->AddPacketToTransaction(lane.request, lane.request);
+				lane.requestPaired = true;
+			}
+			mResults->AddPacketToTransaction(lane.request, packetId);
+		}
+		break;
 
-		/* Fill frame with data. */
-		frame.mData1 = byte;
-		frame.mData2 = ((byteCount & UINT32_MAX) << 32U) | (byteIndex & UINT32_MAX);
+	case FRAME_TYPE_TURNAROUND:
+		/* Replies to a request end with the turnaround back to the host. */
+		if (!(type & FRAME_TYPE_REVERSE)) {
+			lane.request = INVALID_RESULT_INDEX;
+		}
+		break;
 
-		mResults->AddFrame(frame);
-		byteIndex++;
+	default:
+		break;
 	}
+}
 
-	U64 bitsRemaining = data.size(); /* Ideally all bits have been processed. */
-	data.clear();
-	mResults->CommitResults();
+void MIPI_DSI_LP_Analyzer::UpdateResults(U64 sample)
+{
+	/* Commit in batches: every commit is a round trip to Logic. */
+	if ((mFramesSinceCommit >= COMMIT_FRAME_INTERVAL) || ((sample >= mCommitSample) && ((sample - mCommitSample) >= mCommitSampleInterval))) {
+		FlushResults(sample);
+	}
+}
 
-	return bitsRemaining;
+void MIPI_DSI_LP_Analyzer::FlushResults(U64 sample)
+{
+	if (mResultsPending) {
+		mResults->CommitResults();
+	}
+	ReportProgress(sample);
+	mCommitSample = sample;
+	mFramesSinceCommit = 0;
+	mResultsPending = false;
 }
 
 bool MIPI_DSI_LP_Analyzer::NeedsRerun()
@@ -7,6 +7,28 @@
 #include <AnalyzerHelpers.h>
 #include "MIPI_DSI_LP_AnalyzerResults.h"
 #include "MIPI_DSI_LP_SimulationDataGenerator.h"
+#include "MIPI_DSI_LP_LineCursor.h"
+#include "MIPI_DSI_LP_PulseEstimator.h"
+#include "MIPI_DSI_LP_AnalyzerSettings.h"
+#include <deque>
+
+/* Escape mode decoder states. */
+enum LpState
+{
+	LP_STATE_IDLE = 0,		/* Waiting for the stop state: HS bursts and broken sequences are skipped. */
+	LP_STATE_STOP,			/* LP-11. */
+	LP_STATE_ESC_RQST,		/* LP-10: escape request. */
+	LP_STATE_ESC_BRIDGE,	/* LP-00: bridge. */
+	LP_STATE_ESC_ACK,		/* LP-01: entry pulse on D-. */
+	LP_STATE_SPACE,			/* LP-00: between bits. */
+	LP_STATE_MARK_1,		/* LP-10: one bit, or the start of the stop sequence. */
+	LP_STATE_MARK_0,		/* LP-01: zero bit. */
+	LP_STATE_HS_RQST,		/* LP-01: high speed request. */
+	LP_STATE_TA_GO,			/* LP-10 after the bridge: bus turnaround request. */
+	LP_STATE_TA_SURE,		/* LP-00: lines handed over to the other side. */
+	LP_STATE_TA_GET,		/* LP-10: driven by the new transmitter. */
+	LP_STATE_COUNT
+};
 
 /* Define Bit structure. */
 struct Bit
@@ -15,6 +37,60 @@ struct Bit
 	BitState value;
 };
 
+/* Streaming byte assembler: LPDT bits are folded into bytes as they are decoded. */
+struct ByteAssembler
+{
+	U64 sampleBegin;	/* First sample of the byte being assembled. */
+	U64 value;			/* Bits received so far, LSB first. */
+	U32 bitCount;		/* Number of bits already in value. */
+};
+
+/* DSI packet being assembled from LPDT bytes. */
+struct PacketAssembler
+{
+	U64 sampleBegin;	/* First sample of the packet. */
+	U64 sampleEnd;		/* Last sample of the latest byte. */
+	U64 header;			/* Header and checksum bytes, packed like a packet frame's mData1. */
+	U32 byteCount;		/* Bytes received so far. */
+	U32 length;			/* Expected packet length, known once the header is in. */
+	U8 flags;			/* PACKET_FLAG_* and DISPLAY_AS_* flags collected so far. */
+	U8 dtClass;			/* DSI_DataTypeClass of the packet, tagged onto its frames. */
+	bool resync;		/* Expected from the peripheral, but a host packet: direction put back to host. */
+	U16 crc;			/* Running payload CRC. */
+	U8 crcBlock[8];		/* Payload bytes waiting to be folded into the CRC. */
+	U32 crcBlockLength;
+	std::vector<U8> payload;	/* Payload bytes (packet frame mode only). */
+};
+
+/* Frames of one packet, escape command or bus turnaround: they go into the results together. */
+struct FrameGroup
+{
+	U8 type;					/* Frame type of the group, with FRAME_TYPE_REVERSE. */
+	std::vector<Frame> frames;
+};
+
+/* Decoder state of one data lane. */
+struct LaneDecoder
+{
+	U8 index;			/* Lane number. */
+	Channel pos, neg;
+	AnalyzerChannelData *dataP, *dataN;
+	MIPI_DSI_LP_LineCursor cursor;
+	MIPI_DSI_LP_PulseEstimator pulse;
+	U8 lpState;
+	U64 sampleStart;
+	U64 startToPulse;
+	U64 markBegin;
+	ByteAssembler bytes;
+	U8 escapeCommand;	/* DSI_EscapeCommand of the current burst. */
+	PacketAssembler packet;
+	std::vector<Frame> frames;	/* Frames of the open group, when several lanes are decoded. */
+	std::deque<FrameGroup> held;	/* Finished groups, waiting for the other lanes to get past them. */
+	bool reverse;		/* Peripheral is transmitting, after a bus turnaround. */
+	U64 request;		/* Packet id of the last host packet added, the request replies are paired with. */
+	bool requestPaired;	/* Request already added to its transaction. */
+};
+
 class MIPI_DSI_LP_AnalyzerSettings;
 class ANALYZER_EXPORT MIPI_DSI_LP_Analyzer : public Analyzer2
 {
@@ -35,23 +111,44 @@ public:
 #pragma warning( disable : 4251 ) //warning C4251: class <...> needs to have dll-interface to be used by clients of class
 
 protected: // functions
-	bool GetStart(void);
-	U64 GetBitstream(void);
-	U64 GetData(void);
+	LaneDecoder* NextLane(void);
+	void WaitForLanes(void);
+	U64 GetLaneHorizon(LaneDecoder& lane);
+	void DecodeEvent(LaneDecoder& lane, const LineEvent& event);
+	void EndBurst(LaneDecoder& lane);
+	void AddBit(LaneDecoder& lane, const Bit& bit);
+	void AddEntryBit(LaneDecoder& lane, const Bit& bit);
+	void AddByte(LaneDecoder& lane, U8 value, U64 sampleBegin, U64 sampleEnd);
+	void ClosePacket(LaneDecoder& lane);
+	void AddTurnaround(LaneDecoder& lane, U64 sample);
+	void AddMarker(U64 sample, AnalyzerResults::MarkerType type, Channel& channel);
+	void AddFrame(LaneDecoder& lane, Frame& frame);
+	void AddFrame(const Frame& frame);
+	void EndGroup(LaneDecoder& lane, U8 type);
+	void ReleaseGroups(void);
+	void AddGroup(LaneDecoder& lane, FrameGroup& group);
+	void PairPacket(LaneDecoder& lane, U8 type, U64 packetId);
+	void UpdateResults(U64 sample);
+	void FlushResults(U64 sample);
 
 protected: // vars
 	std::auto_ptr< MIPI_DSI_LP_AnalyzerSettings > mSettings;
 	std::auto_ptr< MIPI_DSI_LP_AnalyzerResults > mResults;
-	AnalyzerChannelData *mDataP, *mDataN;
+	LaneDecoder mLanes[DSI_LANE_COUNT];	/* Enabled lanes first. */
+	U32 mLaneCount;
+	U32 mHeldGroups;			/* Groups held on all lanes. */
+	U64 mNextFrameSample;		/* Frames held back on several lanes can start from here, after the last one added. */
 
 	MIPI_DSI_LP_SimulationDataGenerator mSimulationDataGenerator;
 	bool mSimulationInitialized;
 
 	// Analyzer vars:
 	U32 mSampleRateHz;
-	U64 sampleStart;
-	U64 pulseLength;
-	std::vector<Bit> data;
+	U32 mMarkerMask; /* Bit per AnalyzerResults::MarkerType allowed by the marker density setting. */
+	U64 mCommitSample;			/* Sample reached at the last commit. */
+	U64 mCommitSampleInterval;	/* Samples between commits. */
+	U32 mFramesSinceCommit;
+	bool mResultsPending;		/* Frames or markers added since the last commit. */
 	// For debug
 	FILE *pFile;
 #pragma warning( pop )
@@ -2,64 +2,75 @@
 #include <AnalyzerHelpers.h>
 #include "MIPI_DSI_LP_Analyzer.h"
 #include "MIPI_DSI_LP_AnalyzerSettings.h"
-#include <iostream>
-#include <fstream>
-#include <sstream>
+#include "MIPI_DSI_LP_Packet.h"
+#include "MIPI_DSI_LP_ExportWriter.h"
+#include "MIPI_DSI_LP_Pixels.h"
+#include "MIPI_DSI_LP_Framebuffer.h"
 #include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
 
-struct MIPI_DSI_Packet {
-	uint8_t DataType;
-	int32_t parametersCount;
-	std::string description;
+/* Appends formatted text at len, truncating at size. Text generation stays allocation-free. */
+static void DSI_AppendText(char* text, size_t size, size_t& len, const char* format, ...)
+{
+	va_list args;
+
+	if (len >= size) {
+		return;
+	}
+	va_start(args, format);
+	int written = vsnprintf(text + len, size - len, format, args);
+	va_end(args);
+	if (written > 0) {
+		len += size_t(written);
+		if (len >= size) {
+			len = size - 1;
+		}
+	}
+}
+
+/* pcapng block types, and the link type used for DSI packets (LINKTYPE_USER0: no DSI link type is registered). */
+#define PCAPNG_SECTION_HEADER			0x0A0D0D0A
+#define PCAPNG_INTERFACE_DESCRIPTION	0x00000001
+#define PCAPNG_ENHANCED_PACKET			0x00000006
+#define PCAPNG_LINKTYPE					147
+
+/* Export rows written between progress updates. */
+#define EXPORT_PROGRESS_INTERVAL	4096U
+
+/* Names of the byte roles, indexed by MIPI_DSI_LP_ByteRole. */
+static const char* DSI_byteRoleNames[] =
+{
+	"DI", "Data", "WC", "ECC", "Payload", "Checksum"
 };
 
-struct MIPI_DSI_Packet DSI_packets[] =
-{
-	{0x01, -1, "Sync Event, V Sync Start"},
-	{0x11, -1, "Sync Event, V Sync End"},
-	{0x21, -1, "Sync Event, H Sync Start"},
-	{0x31, -1, "Sync Event, H Sync End"},
-	{0x07, -1, "Compression Mode Command"},
-	{0x08, -1, "End of Transmission packet(EoTp)"},
-	{0x02, -1, "Color Mode(CM) Off Command"},
-	{0x12, -1, "Color Mode(CM) On Command"},
-	{0x22, -1, "Shut Down Peripheral Command"},
-	{0x32, -1, "Turn On Peripheral Command"},
-	{0x03, 0, "Generic Short WRITE"},
-	{0x13, 1, "Generic Short WRITE"},
-	{0x23, 2, "Generic Short WRITE"},
-	{0x04, 0, "Generic READ"},
-	{0x14, 1, "Generic READ"},
-	{0x24, 2, "Generic READ"},
-	{0x05, 0, "DCS Short WRITE"},
-	{0x15, 1, "DCS Short WRITE"},
-	{0x06, 0, "DCS READ"},
-	{0x16, -1, "Execute Queue"},
-	{0x37, -1, "Set Maximum Return Packet Size"},
-	{0x09, -1, "Null Packet"},
-	{0x19, -1, "Blanking Packet"},
-	{0x29, -1, "Generic Long Write"},
-	{0x39, -1, "DCS Long Write / write_LUT Command Packet"},
-	{0x0A, -1, "Picture Parameter Set"},
-	{0x0B, -1, "Compressed Pixel Stream"},
-	{0x0C, -1, "Loosely Packed Pixel Stream, 20 - bit YCbCr, 4:2 : 2 Format"},
-	{0x1C, -1, "Packed Pixel Stream, 24 - bit YCbCr, 4 : 2 : 2 Format"},
-	{0x2C, -1, "Packed Pixel Stream, 16 - bit YCbCr, 4 : 2 : 2 Format"},
-	{0x0D, -1, "Packed Pixel Stream, 30 - bit RGB, 10 - 10 - 10 Format"},
-	{0x1D, -1, "Packed Pixel Stream, 36 - bit RGB, 12 - 12 - 12 Format"},
-	{0x3D, -1, "Packed Pixel Stream, 12 - bit YCbCr, 4 : 2 : 0 Format"},
-	{0x0E, -1, "Packed Pixel Stream, 16 - bit RGB, 5 - 6 - 5 Format"},
-	{0x1E, -1, "Packed Pixel Stream, 18 - bit RGB, 6 - 6 - 6 Format"},
-	{0x2E, -1, "Loosely Packed Pixel Stream, 18 - bit RGB, 6 - 6 - 6 Format"},
-	{0x3E, -1, "Packed Pixel Stream, 24 - bit RGB, 8 - 8 - 8 Format"}
+/* Short and full names of the entry commands, indexed by DSI_EscapeCommand. */
+static const char* DSI_escapeNames[][2] =
+{
+	{"?", "Unknown entry command"},
+	{"LPDT", "Low-Power Data Transmission"},
+	{"ULPS", "Ultra-Low Power State"},
+	{"Reset", "Remote Application Reset"},
+	{"TE", "Tearing Effect"},
+	{"ACK", "Acknowledge"},
+	{"Unknown-5", "Unknown-5 trigger"}
 };
 
 MIPI_DSI_LP_AnalyzerResults::MIPI_DSI_LP_AnalyzerResults( MIPI_DSI_LP_Analyzer* analyzer, MIPI_DSI_LP_AnalyzerSettings* settings )
 :	AnalyzerResults(),
 	mSettings( settings ),
-	mAnalyzer( analyzer )
+	mAnalyzer( analyzer ),
+	mPixelWidth( 0 ),
+	mPixelRows( 0 ),
+	mPixelScan( false ),
+	mFramebufferCount( 0 )
 {
-	DSI_packetsCount = sizeof(DSI_packets) / sizeof(DSI_packets[0]);
+	mMultiLane = false;
+	for (U32 i = 1; i < DSI_LANE_COUNT; i++) {
+		if (mSettings->mPosChannel[i] != UNDEFINED_CHANNEL) {
+			mMultiLane = true;
+		}
+	}
 }
 
 MIPI_DSI_LP_AnalyzerResults::~MIPI_DSI_LP_AnalyzerResults()
@@ -68,98 +79,643 @@ MIPI_DSI_LP_AnalyzerResults::~MIPI_DSI_LP_AnalyzerResults()
 
 void MIPI_DSI_LP_AnalyzerResults::GenerateBubbleText( U64 frame_index, Channel& channel, DisplayBase display_base )
 {
-	char number_str[128];
-	static int32_t lastDTindex = -1;
-
+	/* Every frame describes itself: the text depends on this frame alone, in any order and from any thread. */
 	ClearResultStrings();
 	Frame frame = GetFrame( frame_index );
 
-	/* Convert the data byte into a string for generic result string. */
-	AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
-
-	/* Check if it's the first byte of the packet. */
-	if ((frame.mData2 & UINT32_MAX) == 0U) {
-		char number_str_VC[16];
-		char number_str_DT[16];
-		std::stringstream ss;
+	/* Bubbles only go on the D+ line of the frame's own lane. */
+	if (mMultiLane && !(channel == mSettings->mPosChannel[FRAME_LANE(frame.mFlags)])) {
+		return;
+	}
 
-		ss << "DI [" << number_str << "]";
-		AddResultString(ss.str().c_str());
-		ss.str("");
+	/* Packet frames carry their own header. */
+	if (FRAME_KIND(frame.mType) == FRAME_TYPE_PACKET) {
+		GeneratePacketText(frame, display_base, false);
+		return;
+	}
+	if ((FRAME_KIND(frame.mType) == FRAME_TYPE_ESCAPE) || (FRAME_KIND(frame.mType) == FRAME_TYPE_TURNAROUND)) {
+		GenerateEscapeText(frame, display_base, false);
+		return;
+	}
 
-		/* Virtual Channel Field is DI[7:6]. */
-		AnalyzerHelpers::GetNumberString((frame.mData1 >> 6) & 0x3, display_base, 2, number_str_VC, 16);
-		/* Data Type Field is DI[5:0]. */
-		AnalyzerHelpers::GetNumberString(frame.mData1 & 0x3F, display_base, 6, number_str_DT, 16);
-
-		/* Reset last known DT index. */
-		lastDTindex = -1;
-		/* Loop through DSI_packets array. */
-		for (uint32_t i = 0; i < DSI_packetsCount; i++) {
-			/* Check if data type field matches. */
-			if (DSI_packets[i].DataType == (frame.mData1 & 0x3F)) {
-				/* Remember last known DT index. */
-				lastDTindex = i;
-				break;
-			}
-		}
+	GenerateByteText(frame, display_base, false);
+}
 
-		/* If Data Type is known. */
-		if (lastDTindex != -1) {
-			/* Show data type and description. */
-			ss << "VC [" << number_str_VC << "] " << " DT [" << number_str_DT << "] = " << DSI_packets[lastDTindex].description;
-			AddResultString(ss.str().c_str());
-			ss.str("");
+void MIPI_DSI_LP_AnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+{
+	MIPI_DSI_LP_ExportWriter writer;
 
-			/* Show data type, description, and number of parameters (if applicable). */
-			ss << "VC [" << number_str_VC << "] " << " DT [" << number_str_DT << "] = " << DSI_packets[lastDTindex].description << ((DSI_packets[lastDTindex].parametersCount >= 0) ? (" (" + std::to_string(DSI_packets[lastDTindex].parametersCount) + " parameters)"):"");
-			AddResultString(ss.str().c_str());
-			ss.str("");
-		} else {
-		/* Data Type is unknown. */
-			ss << "VC [" << number_str_VC << "] " << "DT [" << number_str_DT << "]";
-			AddResultString(ss.str().c_str());
-			ss.str("");
+	/* Framebuffer snapshots open files of their own. */
+	if ((export_type_user_id != EXPORT_FRAMEBUFFER) && !writer.Open(file, (export_type_user_id == EXPORT_PCAPNG) || (export_type_user_id == EXPORT_PIXELS))) {
+		return;
+	}
 
-			ss << "Virtual Channel [" << number_str_VC << "] " << "Data Type [" << number_str_DT << "]";
-			AddResultString(ss.str().c_str());
-			ss.str("");
-		}
-	} else {
-		AddResultString(number_str);
+	switch (export_type_user_id) {
+	case EXPORT_PACKETS:
+	case EXPORT_PCAPNG:
+	case EXPORT_NDJSON:
+		ExportPackets(writer, display_base, export_type_user_id);
+		break;
+	case EXPORT_PIXELS:
+		ExportPixels(writer, display_base);
+		break;
+	case EXPORT_FRAMEBUFFER:
+		ExportFramebuffer(writer, display_base, file);
+		break;
+	default:
+		ExportFrames(writer, display_base);
+		break;
 	}
 }
 
-void MIPI_DSI_LP_AnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+void MIPI_DSI_LP_AnalyzerResults::ExportFrames(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base)
 {
-	std::ofstream file_stream( file, std::ios::out );
-
 	U64 trigger_sample = mAnalyzer->GetTriggerSample();
 	U32 sample_rate = mAnalyzer->GetSampleRate();
 
-	file_stream << "Time [s],Value" << std::endl;
+	writer.Print(mMultiLane ? "Time [s],Lane,Value,CRC errors\n" : "Time [s],Value,CRC errors\n");
+
+	/* Payload of packet frames, reused from row to row. */
+	std::vector<U8> payload;
 
+	U64 crc_errors = 0;
 	U64 num_frames = GetNumFrames();
-	for( U32 i=0; i < num_frames; i++ )
+	for( U64 i=0; i < num_frames; i++ )
 	{
 		Frame frame = GetFrame( i );
-		
+
 		char time_str[128];
 		AnalyzerHelpers::GetTimeString( frame.mStartingSampleInclusive, trigger_sample, sample_rate, time_str, 128 );
+		writer.Print(time_str);
+		if (mMultiLane) {
+			writer.Printf(",%u,", FRAME_LANE(frame.mFlags));
+		} else {
+			writer.Print(",");
+		}
+
+		/* Running count of packets that failed their checksum. */
+		if (frame.mFlags & PACKET_FLAG_CRC_ERROR) {
+			crc_errors++;
+		}
 
 		char number_str[128];
-		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
+		if (FRAME_KIND(frame.mType) == FRAME_TYPE_PACKET) {
+			/* Packet frames export all of their bytes in one row. */
+			U32 payloadLength = PACKET_PAYLOAD_LENGTH(frame.mData2);
 
-		file_stream << time_str << "," << number_str << std::endl;
+			for (U32 b = 0; b < DSI_HEADER_LENGTH; b++) {
+				AnalyzerHelpers::GetNumberString( PACKET_HEADER_BYTE(frame.mData1, b), display_base, 8, number_str, 128 );
+				writer.Printf((b > 0) ? " %s" : "%s", number_str);
+			}
+			if (payloadLength > 0) {
+				payload.resize(payloadLength);
+				GetPayload(PACKET_PAYLOAD_OFFSET(frame.mData2), &payload[0], payloadLength);
+				for (U32 b = 0; b < payloadLength; b++) {
+					AnalyzerHelpers::GetNumberString( payload[b], display_base, 8, number_str, 128 );
+					writer.Printf(" %s", number_str);
+				}
+			}
+			if (DSI_IsLongPacket(PACKET_HEADER_BYTE(frame.mData1, 0)) && !(frame.mFlags & (PACKET_FLAG_TRUNCATED | PACKET_FLAG_ECC_ERROR))) {
+				for (U32 b = 0; b < DSI_FOOTER_LENGTH; b++) {
+					AnalyzerHelpers::GetNumberString( (PACKET_CHECKSUM(frame.mData1) >> (8U * b)) & 0xFF, display_base, 8, number_str, 128 );
+					writer.Printf(" %s", number_str);
+				}
+			}
+		} else if (FRAME_KIND(frame.mType) == FRAME_TYPE_ESCAPE) {
+			AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
+			writer.Printf("%s %s", DSI_escapeNames[frame.mData2][0], number_str);
+		} else if (FRAME_KIND(frame.mType) == FRAME_TYPE_TURNAROUND) {
+			writer.Print((frame.mType & FRAME_TYPE_REVERSE) ? "BTA to peripheral" : "BTA to host");
+		} else {
+			AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
+			writer.Print(number_str);
+		}
+		writer.Printf(",%llu\n", (unsigned long long)crc_errors);
 
-		if( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true )
+		/* Progress and cancel are checked once per batch of rows. */
+		if( ((i % EXPORT_PROGRESS_INTERVAL) == 0) && (UpdateExportProgressAndCheckForCancel( i, num_frames ) == true) )
 		{
-			file_stream.close();
 			return;
 		}
 	}
 
-	file_stream.close();
+	UpdateExportProgressAndCheckForCancel( num_frames, num_frames );
+}
+
+/* ECC verdict of a packet, from its frame flags, or "truncated" when the burst ended inside the header. */
+static const char* DSI_EccVerdict(U8 flags, U32 count)
+{
+	if (count < DSI_HEADER_LENGTH) {
+		return "truncated";
+	}
+	if (flags & PACKET_FLAG_ECC_ERROR) {
+		return "error";
+	}
+	return (flags & PACKET_FLAG_ECC_CORRECTED) ? "corrected" : "OK";
+}
+
+/* CRC verdict of a packet from its (corrected) header, empty for short packets and for a header that didn't arrive
+   whole or that the ECC couldn't fix: only a long packet whose length is known has one. */
+static const char* DSI_CrcVerdict(U8 flags, U32 header, const U8* bytes, U32 count)
+{
+	if ((count < DSI_HEADER_LENGTH) || !DSI_IsLongPacket(U8(header)) || (flags & PACKET_FLAG_ECC_ERROR)) {
+		return "";
+	}
+	if ((flags & PACKET_FLAG_TRUNCATED) || (count < (DSI_HEADER_LENGTH + ((header >> 8) & 0xFFFF) + DSI_FOOTER_LENGTH))) {
+		return "truncated";
+	}
+	if (flags & PACKET_FLAG_CRC_ERROR) {
+		return "error";
+	}
+	return ((bytes[count - 2] | (bytes[count - 1] << 8)) == DSI_CRC_NOT_CALCULATED) ? "not calculated" : "OK";
+}
+
+/* Payload of a packet from its (corrected) header: data 0 and 1 of a short packet, or what arrived of a long one.
+   None when the burst ended inside the header. */
+static U32 DSI_GetPacketPayload(U32 header, const U8* bytes, U32 count, const U8** payload)
+{
+	if (count < DSI_HEADER_LENGTH) {
+		*payload = bytes;
+		return 0;
+	}
+	if (!DSI_IsLongPacket(U8(header))) {
+		*payload = &bytes[1];
+		return 2;
+	}
+
+	U32 length = count - DSI_HEADER_LENGTH;
+	U32 wordCount = (header >> 8) & 0xFFFF;
+	*payload = &bytes[DSI_HEADER_LENGTH];
+	return (length < wordCount) ? length : wordCount;
+}
+
+/* Writes bytes in hex, two digits per byte, a chunk at a time. */
+static void DSI_WriteHex(MIPI_DSI_LP_ExportWriter& writer, const U8* data, U32 length)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	char text[256];
+	U32 textLength = 0;
+
+	for (U32 b = 0; b < length; b++) {
+		text[textLength++] = hex[data[b] >> 4];
+		text[textLength++] = hex[data[b] & 0x0F];
+		if (textLength == sizeof(text)) {
+			writer.Write(text, textLength);
+			textLength = 0;
+		}
+	}
+	writer.Write(text, textLength);
+}
+
+bool MIPI_DSI_LP_AnalyzerResults::ExportPackets(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base, U32 export_type, U32 pass, U32 passes)
+{
+	if (export_type == EXPORT_PCAPNG) {
+		WritePcapngHeader(writer);
+	} else if (export_type == EXPORT_PACKETS) {
+		writer.Print(mMultiLane ? "Start [s],End [s],Lane,VC,DT,Description,WC,ECC,CRC,DCS command,Payload\n" : "Start [s],End [s],VC,DT,Description,WC,ECC,CRC,DCS command,Payload\n");
+	}
+
+	/* Bytes of the current packet, reused from packet to packet. In byte mode they come one frame at a time. */
+	std::vector<U8> bytes;
+	Frame packet;
+	bool pending = false;
+
+	U64 num_frames = GetNumFrames();
+	U64 progress = num_frames * pass;
+	for (U64 i = 0; i < num_frames; i++)
+	{
+		Frame frame = GetFrame(i);
+
+		/* A byte frame with index 0, or any other frame, ends the packet in progress. */
+		if (pending && ((FRAME_KIND(frame.mType) != FRAME_TYPE_BYTE) || (BYTE_INDEX(frame.mData2) == 0))) {
+			WritePacket(writer, packet, &bytes[0], U32(bytes.size()), display_base, export_type);
+			pending = false;
+		}
+
+		if (FRAME_KIND(frame.mType) == FRAME_TYPE_PACKET) {
+			/* Packet frames hold the whole packet, the header already corrected. */
+			U32 payloadLength = PACKET_PAYLOAD_LENGTH(frame.mData2);
+
+			bytes.resize(DSI_HEADER_LENGTH + payloadLength);
+			for (U32 b = 0; b < DSI_HEADER_LENGTH; b++) {
+				bytes[b] = PACKET_HEADER_BYTE(frame.mData1, b);
+			}
+			if (payloadLength > 0) {
+				GetPayload(PACKET_PAYLOAD_OFFSET(frame.mData2), &bytes[DSI_HEADER_LENGTH], payloadLength);
+			}
+			if (DSI_IsLongPacket(bytes[0]) && !(frame.mFlags & (PACKET_FLAG_TRUNCATED | PACKET_FLAG_ECC_ERROR))) {
+				bytes.push_back(PACKET_CHECKSUM(frame.mData1) & 0xFF);
+				bytes.push_back(PACKET_CHECKSUM(frame.mData1) >> 8);
+			}
+			WritePacket(writer, frame, &bytes[0], U32(bytes.size()), display_base, export_type);
+		} else if (FRAME_KIND(frame.mType) == FRAME_TYPE_BYTE) {
+			if (!pending) {
+				/* Field by field: the SDK's Frame has no assignment operator of its own. */
+				packet.mStartingSampleInclusive = frame.mStartingSampleInclusive;
+				packet.mData1 = frame.mData1;
+				packet.mData2 = frame.mData2;
+				packet.mType = frame.mType;
+				packet.mFlags = frame.mFlags;
+				bytes.clear();
+				pending = true;
+			}
+			bytes.push_back(U8(frame.mData1));
+			packet.mEndingSampleInclusive = frame.mEndingSampleInclusive;
+			packet.mFlags |= frame.mFlags;
+		}
+
+		/* Progress and cancel are checked once per batch of frames. */
+		if (((i % EXPORT_PROGRESS_INTERVAL) == 0) && (UpdateExportProgressAndCheckForCancel(progress + i, num_frames * passes) == true))
+		{
+			return false;
+		}
+	}
+
+	if (pending) {
+		WritePacket(writer, packet, &bytes[0], U32(bytes.size()), display_base, export_type);
+	}
+	return !UpdateExportProgressAndCheckForCancel(progress + num_frames, num_frames * passes);
+}
+
+void MIPI_DSI_LP_AnalyzerResults::WritePacket(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count, DisplayBase display_base, U32 export_type)
+{
+	if (export_type == EXPORT_PCAPNG) {
+		WritePcapngBlock(writer, frame, bytes, count);
+	} else if (export_type == EXPORT_NDJSON) {
+		WritePacketJson(writer, frame, bytes, count);
+	} else if (export_type == EXPORT_PIXELS) {
+		WritePixelRow(writer, frame, bytes, count);
+	} else if (export_type == EXPORT_FRAMEBUFFER) {
+		AddFramebufferPacket(frame, bytes, count);
+	} else {
+		WritePacketRow(writer, frame, bytes, count, display_base);
+	}
+}
+
+void MIPI_DSI_LP_AnalyzerResults::WritePacketRow(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count, DisplayBase display_base)
+{
+	char time_str[128];
+	char number_str[128];
+	U64 trigger_sample = mAnalyzer->GetTriggerSample();
+	U32 sample_rate = mAnalyzer->GetSampleRate();
+
+	AnalyzerHelpers::GetTimeString(frame.mStartingSampleInclusive, trigger_sample, sample_rate, time_str, 128);
+	writer.Print(time_str);
+	AnalyzerHelpers::GetTimeString(frame.mEndingSampleInclusive, trigger_sample, sample_rate, time_str, 128);
+	writer.Printf(",%s,", time_str);
+	if (mMultiLane) {
+		writer.Printf("%u,", FRAME_LANE(frame.mFlags));
+	}
+
+	/* A burst that ended inside the header leaves only what its DI byte, if any, says. */
+	U32 header = DSI_GetPacketHeader(bytes, count);
+	bool complete = (count >= DSI_HEADER_LENGTH);
+
+	U8 di = U8(header);
+	U8 dt = DSI_GetDataType(di);
+	const DSI_DataTypeInfo& dataType = DSI_GetDataTypeInfo(dt, (frame.mType & FRAME_TYPE_REVERSE) != 0);
+	bool isLong = DSI_IsLongPacket(di);
+	U32 wordCount = (header >> 8) & 0xFFFF;
+
+	if (count > 0) {
+		AnalyzerHelpers::GetNumberString(DSI_GetVirtualChannel(di), display_base, 2, number_str, 128);
+		writer.Printf("%s,", number_str);
+		AnalyzerHelpers::GetNumberString(dt, display_base, 6, number_str, 128);
+		writer.Printf("%s,\"%s\",", number_str, (dataType.description != NULL) ? dataType.description : "");
+	} else {
+		writer.Print(",,,");
+	}
+
+	/* Word count, ECC and CRC verdicts. */
+	if (isLong && complete) {
+		writer.Printf("%u,", wordCount);
+	} else {
+		writer.Print(",");
+	}
+	writer.Printf("%s,", DSI_EccVerdict(frame.mFlags, count));
+
+	writer.Printf("%s,", DSI_CrcVerdict(frame.mFlags, header, bytes, count));
+
+	const U8* payload;
+	U32 payloadLength = DSI_GetPacketPayload(header, bytes, count, &payload);
+
+	/* DCS command: data 0 of a DCS short packet, first payload byte of a DCS long write. */
+	if (complete && ((frame.mType & FRAME_TYPE_REVERSE) == 0)) {
+		if ((dt == 0x05) || (dt == 0x15) || (dt == 0x06)) {
+			AnalyzerHelpers::GetNumberString(bytes[1], display_base, 8, number_str, 128);
+			writer.Print(number_str);
+		} else if ((dt == 0x39) && (payloadLength > 0)) {
+			AnalyzerHelpers::GetNumberString(payload[0], display_base, 8, number_str, 128);
+			writer.Print(number_str);
+		}
+	}
+	writer.Print(",");
+
+	DSI_WriteHex(writer, payload, payloadLength);
+	writer.Print("\n");
+}
+
+void MIPI_DSI_LP_AnalyzerResults::ExportPixels(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base)
+{
+	/* First pass sizes the image: one row per pixel stream packet, as wide as the longest one. */
+	mPixelWidth = 0;
+	mPixelRows = 0;
+	mPixelScan = true;
+	if (!ExportPackets(writer, display_base, EXPORT_PIXELS, 0, 2) || (mPixelRows == 0)) {
+		return;
+	}
+
+	/* Second pass unpacks the rows, shorter ones padded with black. */
+	writer.Printf("P6\n%u %llu\n255\n", mPixelWidth, (unsigned long long)mPixelRows);
+	mPixelRow.resize(DSI_RGB_PIXEL_LENGTH * mPixelWidth);
+	mPixelScan = false;
+	ExportPackets(writer, display_base, EXPORT_PIXELS, 1, 2);
+}
+
+void MIPI_DSI_LP_AnalyzerResults::WritePixelRow(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count)
+{
+	/* Pixel streams from the host with a header that can be trusted. */
+	if ((count < DSI_HEADER_LENGTH) || (frame.mType & FRAME_TYPE_REVERSE) || (frame.mFlags & PACKET_FLAG_ECC_ERROR)) {
+		return;
+	}
+
+	U32 header = DSI_GetPacketHeader(bytes, count);
+
+	U8 dt = DSI_GetDataType(U8(header));
+	U32 wordCount = (header >> 8) & 0xFFFF;
+	if (!DSI_IsLongPacket(U8(header)) || (DSI_GetPixelCount(dt, wordCount) == 0)) {
+		return;
+	}
+
+	if (mPixelScan) {
+		U32 width = DSI_GetPixelCount(dt, wordCount);
+		if (width > mPixelWidth) {
+			mPixelWidth = width;
+		}
+		mPixelRows++;
+		return;
+	}
+
+	/* A truncated packet unpacks as much as arrived. */
+	const U8* payload;
+	U32 payloadLength = DSI_GetPacketPayload(header, bytes, count, &payload);
+	U32 pixels = DSI_UnpackPixels(dt, payload, payloadLength, &mPixelRow[0]);
+
+	/* Rows narrower than the image are padded with black. */
+	if (pixels < mPixelWidth) {
+		memset(&mPixelRow[DSI_RGB_PIXEL_LENGTH * pixels], 0, DSI_RGB_PIXEL_LENGTH * (mPixelWidth - pixels));
+	}
+	writer.Write(&mPixelRow[0], U32(mPixelRow.size()));
+}
+
+void MIPI_DSI_LP_AnalyzerResults::ExportFramebuffer(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base, const char* file)
+{
+	/* One PPM file per frame drawn, named after the export file with its extension swapped for a number:
+	   <name>_0000.ppm, <name>_0001.ppm, ... */
+	mFramebufferFile = file;
+	size_t dot = mFramebufferFile.find_last_of('.');
+	size_t slash = mFramebufferFile.find_last_of("/\\");
+	if ((dot != std::string::npos) && ((slash == std::string::npos) || (dot > slash))) {
+		mFramebufferFile.erase(dot);
+	}
+	mFramebufferCount = 0;
+
+	/* The last frame goes out even if it was still being drawn. */
+	mFramebuffer.Reset();
+	if (ExportPackets(writer, display_base, EXPORT_FRAMEBUFFER) && mFramebuffer.IsDirty()) {
+		WriteFramebufferSnapshot();
+	}
+}
+
+void MIPI_DSI_LP_AnalyzerResults::AddFramebufferPacket(const Frame& frame, const U8* bytes, U32 count)
+{
+	/* DCS writes from the host with a header that can be trusted. */
+	if ((count < DSI_HEADER_LENGTH) || (frame.mType & FRAME_TYPE_REVERSE) || (frame.mFlags & PACKET_FLAG_ECC_ERROR)) {
+		return;
+	}
+
+	U32 header = DSI_GetPacketHeader(bytes, count);
+
+	/* DCS short writes carry the command in data 0, a long write in its first payload byte. */
+	const U8* data;
+	U32 length = DSI_GetPacketPayload(header, bytes, count, &data);
+	switch (DSI_GetDataType(U8(header))) {
+	case 0x05:
+		length = 1;
+		break;
+	case 0x15:
+	case 0x39:
+		break;
+	default:
+		return;
+	}
+	if (length == 0) {
+		return;
+	}
+
+	if (mFramebuffer.EndsFrame(data[0])) {
+		WriteFramebufferSnapshot();
+		mFramebuffer.ClearDirty();
+	}
+	mFramebuffer.AddCommand(data[0], &data[1], length - 1);
+}
+
+void MIPI_DSI_LP_AnalyzerResults::WriteFramebufferSnapshot(void)
+{
+	MIPI_DSI_LP_ExportWriter writer;
+	char suffix[32];
+
+	snprintf(suffix, sizeof(suffix), "_%04u.ppm", mFramebufferCount++);
+	if (!writer.Open((mFramebufferFile + suffix).c_str(), true)) {
+		return;
+	}
+
+	/* Straight from the frame memory model, which holds RGB888 rows already. */
+	writer.Printf("P6\n%u %u\n255\n", mFramebuffer.GetWidth(), mFramebuffer.GetHeight());
+	writer.Write(mFramebuffer.GetImage(), mFramebuffer.GetWidth() * mFramebuffer.GetHeight() * DSI_RGB_PIXEL_LENGTH);
+}
+
+/* Appends a JSON string literal, quoted and escaped. */
+static void DSI_AppendJsonString(char* text, size_t size, size_t& len, const char* value)
+{
+	DSI_AppendText(text, size, len, "\"");
+	for (const char* c = value; *c != '\0'; c++) {
+		if ((*c == '"') || (*c == '\\')) {
+			DSI_AppendText(text, size, len, "\\%c", *c);
+		} else if (U8(*c) < 0x20) {
+			DSI_AppendText(text, size, len, "\\u%04x", U8(*c));
+		} else {
+			DSI_AppendText(text, size, len, "%c", *c);
+		}
+	}
+	DSI_AppendText(text, size, len, "\"");
+}
+
+void MIPI_DSI_LP_AnalyzerResults::WritePacketJson(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count)
+{
+	char text[512];
+	size_t len = 0;
+
+	DSI_AppendText(text, sizeof(text), len, "{\"start_ns\":%llu,\"end_ns\":%llu",
+		(unsigned long long)SampleToNanoseconds(frame.mStartingSampleInclusive), (unsigned long long)SampleToNanoseconds(frame.mEndingSampleInclusive));
+	if (mMultiLane) {
+		DSI_AppendText(text, sizeof(text), len, ",\"lane\":%u", FRAME_LANE(frame.mFlags));
+	}
+	DSI_AppendText(text, sizeof(text), len, ",\"direction\":\"%s\"", (frame.mType & FRAME_TYPE_REVERSE) ? "peripheral" : "host");
+
+	/* A burst that ended inside the header leaves only what its DI byte, if any, says. */
+	U32 header = DSI_GetPacketHeader(bytes, count);
+
+	U8 dt = DSI_GetDataType(U8(header));
+	const DSI_DataTypeInfo& dataType = DSI_GetDataTypeInfo(dt, (frame.mType & FRAME_TYPE_REVERSE) != 0);
+
+	if (count > 0) {
+		DSI_AppendText(text, sizeof(text), len, ",\"vc\":%u,\"dt\":%u", DSI_GetVirtualChannel(U8(header)), dt);
+		if (dataType.description != NULL) {
+			DSI_AppendText(text, sizeof(text), len, ",\"description\":");
+			DSI_AppendJsonString(text, sizeof(text), len, dataType.description);
+		}
+	}
+	if (DSI_IsLongPacket(U8(header)) && (count >= DSI_HEADER_LENGTH)) {
+		DSI_AppendText(text, sizeof(text), len, ",\"wc\":%u", (header >> 8) & 0xFFFF);
+		DSI_AppendText(text, sizeof(text), len, ",\"ecc\":\"%s\",\"crc\":\"%s\"", DSI_EccVerdict(frame.mFlags, count), DSI_CrcVerdict(frame.mFlags, header, bytes, count));
+	} else {
+		DSI_AppendText(text, sizeof(text), len, ",\"ecc\":\"%s\"", DSI_EccVerdict(frame.mFlags, count));
+	}
+	DSI_AppendText(text, sizeof(text), len, ",\"payload\":\"");
+	writer.Write(text, U32(len));
+
+	/* The payload goes straight from the packet bytes to the file. */
+	const U8* payload;
+	U32 payloadLength = DSI_GetPacketPayload(header, bytes, count, &payload);
+	DSI_WriteHex(writer, payload, payloadLength);
+	writer.Write("\"}\n", 3);
+}
+
+U64 MIPI_DSI_LP_AnalyzerResults::SampleToNanoseconds(U64 sample)
+{
+	/* Since the start of the capture, without overflowing on long captures. */
+	U32 sample_rate = mAnalyzer->GetSampleRate();
+	return (sample / sample_rate) * 1000000000ULL + ((sample % sample_rate) * 1000000000ULL) / sample_rate;
+}
+
+/* Appends one pcapng option, padded to 32 bits. Returns the new block length. */
+static U32 DSI_AddPcapngOption(U8* block, U32 length, U16 code, const void* data, U16 dataLength)
+{
+	memcpy(&block[length], &code, 2);
+	memcpy(&block[length + 2], &dataLength, 2);
+	memcpy(&block[length + 4], data, dataLength);
+	length += 4 + dataLength;
+	while (length & 3) {
+		block[length++] = 0;
+	}
+	return length;
+}
+
+void MIPI_DSI_LP_AnalyzerResults::WritePcapngHeader(MIPI_DSI_LP_ExportWriter& writer)
+{
+	U8 block[64];
+	U32 value;
+	U32 length;
+
+	/* Section header block, in host byte order: the byte order magic tells readers which one. */
+	length = 0;
+	value = PCAPNG_SECTION_HEADER;
+	memcpy(&block[length], &value, 4); length += 8;
+	value = 0x1A2B3C4D;
+	memcpy(&block[length], &value, 4); length += 4;
+	U16 version[2] = { 1, 0 };
+	memcpy(&block[length], version, 4); length += 4;
+	S64 sectionLength = -1;
+	memcpy(&block[length], &sectionLength, 8); length += 8;
+	length += 4;
+	memcpy(&block[4], &length, 4);
+	memcpy(&block[length - 4], &length, 4);
+	writer.Write(block, length);
+
+	/* One interface per lane in use, timestamps in nanoseconds. */
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		if (mSettings->mPosChannel[i] == UNDEFINED_CHANNEL) {
+			continue;
+		}
+
+		char name[16];
+		U8 resolution = 9;
+		U16 linkType = PCAPNG_LINKTYPE;
+		U16 reserved = 0;
+		U32 snapLength = 0;
+		U16 end = 0;
+
+		length = 0;
+		value = PCAPNG_INTERFACE_DESCRIPTION;
+		memcpy(&block[length], &value, 4); length += 8;
+		memcpy(&block[length], &linkType, 2); length += 2;
+		memcpy(&block[length], &reserved, 2); length += 2;
+		memcpy(&block[length], &snapLength, 4); length += 4;
+		snprintf(name, sizeof(name), "DSI lane %u", i);
+		length = DSI_AddPcapngOption(block, length, 2, name, U16(strlen(name)));	/* if_name */
+		length = DSI_AddPcapngOption(block, length, 9, &resolution, 1);				/* if_tsresol */
+		length = DSI_AddPcapngOption(block, length, 0, &end, 0);					/* opt_endofopt */
+		length += 4;
+		memcpy(&block[4], &length, 4);
+		memcpy(&block[length - 4], &length, 4);
+		writer.Write(block, length);
+	}
+}
+
+void MIPI_DSI_LP_AnalyzerResults::WritePcapngBlock(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count)
+{
+	static const U8 padding[4] = { 0, 0, 0, 0 };
+	U8 block[64];
+	U32 value;
+	U32 length = 0;
+	U32 originalLength = count;
+
+	/* Interfaces are numbered in lane order, skipping unused lanes. */
+	U32 interfaceId = 0;
+	for (U32 i = 0; i < FRAME_LANE(frame.mFlags); i++) {
+		if (mSettings->mPosChannel[i] != UNDEFINED_CHANNEL) {
+			interfaceId++;
+		}
+	}
+
+	U64 timestamp = SampleToNanoseconds(frame.mStartingSampleInclusive);
+
+	/* A truncated packet keeps the length its header announced, if the ECC let it be read. */
+	U32 header = DSI_GetPacketHeader(bytes, count);
+	if ((count >= DSI_HEADER_LENGTH) && DSI_IsLongPacket(U8(header)) && !(frame.mFlags & PACKET_FLAG_ECC_ERROR)) {
+		U32 expected = DSI_HEADER_LENGTH + ((header >> 8) & 0xFFFF) + DSI_FOOTER_LENGTH;
+		if (expected > originalLength) {
+			originalLength = expected;
+		}
+	} else if (count < DSI_HEADER_LENGTH) {
+		originalLength = DSI_HEADER_LENGTH;
+	}
+
+	/* Enhanced packet block: fixed part, packet bytes straight from the caller, options. */
+	U32 dataPadding = (4 - (count & 3)) & 3;
+	U32 flags = (frame.mType & FRAME_TYPE_REVERSE) ? 1 : 2;	/* Inbound from the peripheral, outbound from the host. */
+	U16 end = 0;
+	U8 options[16];
+	U32 optionsLength = DSI_AddPcapngOption(options, 0, 2, &flags, 4);	/* epb_flags */
+	optionsLength = DSI_AddPcapngOption(options, optionsLength, 0, &end, 0);
+	U32 total = 28 + count + dataPadding + optionsLength + 4;
+
+	value = PCAPNG_ENHANCED_PACKET;
+	memcpy(&block[length], &value, 4); length += 4;
+	memcpy(&block[length], &total, 4); length += 4;
+	memcpy(&block[length], &interfaceId, 4); length += 4;
+	value = U32(timestamp >> 32);
+	memcpy(&block[length], &value, 4); length += 4;
+	value = U32(timestamp);
+	memcpy(&block[length], &value, 4); length += 4;
+	memcpy(&block[length], &count, 4); length += 4;
+	memcpy(&block[length], &originalLength, 4); length += 4;
+	writer.Write(block, length);
+	writer.Write(bytes, count);
+	writer.Write(padding, dataPadding);
+	memcpy(&options[optionsLength], &total, 4);
+	writer.Write(options, optionsLength + 4);
 }
 
 void MIPI_DSI_LP_AnalyzerResults::GenerateFrameTabularText( U64 frame_index, DisplayBase display_base )
@@ -168,18 +724,335 @@ void MIPI_DSI_LP_AnalyzerResults::GenerateFrameTabularText( U64 frame_index, Dis
 	Frame frame = GetFrame( frame_index );
 	ClearTabularText();
 
-	char number_str[128];
-	AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
-	AddTabularText( number_str );
+	/* Packet frames carry their own header. */
+	if (FRAME_KIND(frame.mType) == FRAME_TYPE_PACKET) {
+		GeneratePacketText(frame, display_base, true);
+		return;
+	}
+	if ((FRAME_KIND(frame.mType) == FRAME_TYPE_ESCAPE) || (FRAME_KIND(frame.mType) == FRAME_TYPE_TURNAROUND)) {
+		GenerateEscapeText(frame, display_base, true);
+		return;
+	}
+
+	GenerateByteText(frame, display_base, true);
 #endif
 }
 
 void MIPI_DSI_LP_AnalyzerResults::GeneratePacketTabularText( U64 packet_id, DisplayBase display_base )
 {
-	// Not supported
+#ifdef SUPPORTS_PROTOCOL_SEARCH
+	ClearTabularText();
+	AddPacketTabularText(packet_id, display_base);
+#endif
+}
+
+void MIPI_DSI_LP_AnalyzerResults::AddPacketTabularText( U64 packet_id, DisplayBase display_base )
+{
+#ifdef SUPPORTS_PROTOCOL_SEARCH
+	U64 first_frame_id, last_frame_id;
+
+	GetFramesContainedInPacket(packet_id, &first_frame_id, &last_frame_id);
+	Frame frame = GetFrame(first_frame_id);
+
+	/* In packet mode the packet is a single frame. */
+	if (FRAME_KIND(frame.mType) == FRAME_TYPE_PACKET) {
+		GeneratePacketText(frame, display_base, true);
+		return;
+	}
+	/* So is an entry command other than LPDT, and a bus turnaround. */
+	if ((FRAME_KIND(frame.mType) == FRAME_TYPE_ESCAPE) || (FRAME_KIND(frame.mType) == FRAME_TYPE_TURNAROUND)) {
+		GenerateEscapeText(frame, display_base, true);
+		return;
+	}
+
+	/* In byte mode rebuild the header from the byte frames. */
+	Frame packet;
+	U64 byteCount = last_frame_id - first_frame_id + 1;
+
+	packet.mStartingSampleInclusive = frame.mStartingSampleInclusive;
+	packet.mEndingSampleInclusive = GetFrame(last_frame_id).mEndingSampleInclusive;
+	packet.mData1 = 0;
+	packet.mData2 = 0; /* Payload stays in the byte frames. */
+	/* The last byte carries the class of the ECC-corrected header. */
+	packet.mType = FRAME_TYPE_PACKET | (frame.mType & (FRAME_TYPE_REVERSE | FRAME_TYPE_RESYNC)) | (GetFrame(last_frame_id).mType & FRAME_TYPE_CLASS_MASK);
+	packet.mFlags = 0;
+
+	U8 header[DSI_HEADER_LENGTH];
+	U32 headerCount = U32((byteCount < DSI_HEADER_LENGTH) ? byteCount : DSI_HEADER_LENGTH);
+	for (U32 i = 0; i < headerCount; i++) {
+		Frame byte = GetFrame(first_frame_id + i);
+		header[i] = U8(byte.mData1);
+		/* The ECC byte carries the ECC verdict. */
+		packet.mFlags |= byte.mFlags & (PACKET_FLAG_ECC_CORRECTED | PACKET_FLAG_ECC_ERROR | FRAME_LANE_MASK);
+	}
+	packet.mData1 = DSI_GetPacketHeader(header, headerCount);
+
+	/* A header the ECC couldn't fix ends its packet, whatever its word count says. */
+	if (byteCount < DSI_HEADER_LENGTH) {
+		packet.mFlags |= PACKET_FLAG_TRUNCATED;
+	} else if (DSI_IsLongPacket(packet.mData1 & 0xFF) && !(packet.mFlags & PACKET_FLAG_ECC_ERROR)) {
+		U64 wordCount = (packet.mData1 >> 8) & 0xFFFF;
+
+		if (byteCount < (DSI_HEADER_LENGTH + wordCount + DSI_FOOTER_LENGTH)) {
+			packet.mFlags |= PACKET_FLAG_TRUNCATED;
+		} else {
+			packet.mData1 |= (GetFrame(last_frame_id - 1).mData1 & 0xFF) << 32U;
+			packet.mData1 |= (GetFrame(last_frame_id).mData1 & 0xFF) << 40U;
+			/* The last checksum byte carries the CRC verdict. */
+			packet.mFlags |= GetFrame(last_frame_id).mFlags & PACKET_FLAG_CRC_ERROR;
+		}
+	}
+
+	GeneratePacketText(packet, display_base, true);
+#endif
 }
 
 void MIPI_DSI_LP_AnalyzerResults::GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base )
 {
-	// Not supported
+#ifdef SUPPORTS_PROTOCOL_SEARCH
+	U64* packet_ids;
+	U64 packet_count;
+
+	/* A transaction is a host request followed by the peripheral's replies. */
+	GetPacketsContainedInTransaction(transaction_id, &packet_ids, &packet_count);
+	ClearTabularText();
+	for (U64 i = 0; i < packet_count; i++) {
+		AddPacketTabularText(packet_ids[i], display_base);
+	}
+#endif
+}
+
+void MIPI_DSI_LP_AnalyzerResults::GeneratePacketText(const Frame& frame, DisplayBase display_base, bool tabular)
+{
+	char number_str_VC[16];
+	char number_str_DT[16];
+	char number_str[128];
+	char text[512];
+	size_t len = 0;
+	U8 di = PACKET_HEADER_BYTE(frame.mData1, 0);
+
+	/* Virtual Channel and Data Type fields. */
+	AnalyzerHelpers::GetNumberString(DSI_GetVirtualChannel(di), display_base, 2, number_str_VC, 16);
+	AnalyzerHelpers::GetNumberString(DSI_GetDataType(di), display_base, 6, number_str_DT, 16);
+
+	DSI_AppendText(text, sizeof(text), len, "VC [%s] DT [%s]", number_str_VC, number_str_DT);
+	if (FRAME_CLASS(frame.mType) != DSI_DT_CLASS_UNKNOWN) {
+		DSI_AppendText(text, sizeof(text), len, " = %s", DSI_GetDataTypeInfo(DSI_GetDataType(di), (frame.mType & FRAME_TYPE_REVERSE) != 0).description);
+	}
+
+	if (!tabular) {
+		/* Bubble strings, shortest first. */
+		AddResultString("DT [", number_str_DT, "]");
+		AddResultString(text);
+	}
+
+	/* Long packets carry a word count, short packets two data bytes. */
+	if (DSI_IsLongPacket(di)) {
+		AnalyzerHelpers::GetNumberString((frame.mData1 >> 8) & 0xFFFF, Decimal, 16, number_str, 128);
+		DSI_AppendText(text, sizeof(text), len, " WC [%s]", number_str);
+	} else {
+		AnalyzerHelpers::GetNumberString(PACKET_HEADER_BYTE(frame.mData1, 1), display_base, 8, number_str, 128);
+		DSI_AppendText(text, sizeof(text), len, " Data [%s", number_str);
+		AnalyzerHelpers::GetNumberString(PACKET_HEADER_BYTE(frame.mData1, 2), display_base, 8, number_str, 128);
+		DSI_AppendText(text, sizeof(text), len, " %s]", number_str);
+	}
+	AnalyzerHelpers::GetNumberString(PACKET_HEADER_BYTE(frame.mData1, 3), display_base, 8, number_str, 128);
+	DSI_AppendText(text, sizeof(text), len, " ECC [%s]", number_str);
+	if (frame.mFlags & PACKET_FLAG_ECC_CORRECTED) {
+		DSI_AppendText(text, sizeof(text), len, " (corrected)");
+	}
+	if (frame.mFlags & PACKET_FLAG_ECC_ERROR) {
+		DSI_AppendText(text, sizeof(text), len, " (ECC error)");
+	}
+	if (DSI_IsLongPacket(di) && !(frame.mFlags & (PACKET_FLAG_TRUNCATED | PACKET_FLAG_ECC_ERROR))) {
+		AnalyzerHelpers::GetNumberString(PACKET_CHECKSUM(frame.mData1), display_base, 16, number_str, 128);
+		DSI_AppendText(text, sizeof(text), len, " Checksum [%s]", number_str);
+	}
+	if (frame.mFlags & PACKET_FLAG_CRC_ERROR) {
+		DSI_AppendText(text, sizeof(text), len, " (CRC error)");
+	}
+	if (frame.mFlags & PACKET_FLAG_TRUNCATED) {
+		DSI_AppendText(text, sizeof(text), len, " (truncated)");
+	}
+	if (frame.mType & FRAME_TYPE_RESYNC) {
+		DSI_AppendText(text, sizeof(text), len, " (direction resync)");
+	}
+
+	if (!tabular) {
+		AddResultString(text);
+		return;
+	}
+
+	/* Show the start of the payload in the table. */
+	U32 payloadLength = PACKET_PAYLOAD_LENGTH(frame.mData2);
+	if (payloadLength > 0) {
+		U8 payload[16];
+		U32 previewLength = (payloadLength < sizeof(payload)) ? payloadLength : sizeof(payload);
+
+		GetPayload(PACKET_PAYLOAD_OFFSET(frame.mData2), payload, previewLength);
+		DSI_AppendText(text, sizeof(text), len, " Payload [");
+		for (U32 i = 0; i < previewLength; i++) {
+			AnalyzerHelpers::GetNumberString(payload[i], display_base, 8, number_str, 128);
+			DSI_AppendText(text, sizeof(text), len, (i > 0) ? " %s" : "%s", number_str);
+		}
+		DSI_AppendText(text, sizeof(text), len, (previewLength < payloadLength) ? " ...]" : "]");
+	}
+
+	AddLaneTabularText(frame, text);
+}
+
+void MIPI_DSI_LP_AnalyzerResults::GenerateEscapeText(const Frame& frame, DisplayBase display_base, bool tabular)
+{
+	char number_str[16];
+	const char** names = DSI_escapeNames[frame.mData2];
+
+	/* A bus turnaround names the side that gets the bus. */
+	if (FRAME_KIND(frame.mType) == FRAME_TYPE_TURNAROUND) {
+		const char* text = (frame.mType & FRAME_TYPE_REVERSE) ? "Bus turnaround to peripheral" : "Bus turnaround to host";
+
+		if (tabular) {
+			AddLaneTabularText(frame, text);
+			return;
+		}
+		AddResultString("BTA");
+		AddResultString("Bus turnaround");
+		AddResultString(text);
+		return;
+	}
+
+	AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 16);
+
+	if (tabular) {
+		char text[64];
+		snprintf(text, sizeof(text), "%s [%s]", names[1], number_str);
+		AddLaneTabularText(frame, text);
+		return;
+	}
+
+	/* Bubble strings, shortest first. */
+	AddResultString(names[0]);
+	AddResultString(names[1]);
+	AddResultString(names[1], " [", number_str, "]");
+}
+
+void MIPI_DSI_LP_AnalyzerResults::GenerateByteText(const Frame& frame, DisplayBase display_base, bool tabular)
+{
+	char number_str[128];
+	char number_str_VC[16];
+	char number_str_DT[16];
+	char text[256];
+	char packet_str[64];
+	U8 role = BYTE_ROLE(frame.mData2);
+	const char* verdict = "";
+
+	/* Convert the data byte into a string for generic result string. */
+	AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
+
+	if (role == BYTE_ROLE_DI) {
+		/* Virtual Channel Field is DI[7:6]. */
+		AnalyzerHelpers::GetNumberString(DSI_GetVirtualChannel(U8(frame.mData1)), display_base, 2, number_str_VC, 16);
+		/* Data Type Field is DI[5:0]. */
+		AnalyzerHelpers::GetNumberString(DSI_GetDataType(U8(frame.mData1)), display_base, 6, number_str_DT, 16);
+
+		/* The decoder classified the data type already, only known ones have a description. */
+		if (FRAME_CLASS(frame.mType) != DSI_DT_CLASS_UNKNOWN) {
+			const DSI_DataTypeInfo& dataType = DSI_GetDataTypeInfo(DSI_GetDataType(U8(frame.mData1)), (frame.mType & FRAME_TYPE_REVERSE) != 0);
+			/* A packet the peripheral was expected to send, that turned out to come from the host. */
+			const char* resync = (frame.mType & FRAME_TYPE_RESYNC) ? " (direction resync)" : "";
+
+			if (tabular) {
+				snprintf(text, sizeof(text), "DI [%s] VC [%s] DT [%s] = %s%s", number_str, number_str_VC, number_str_DT, dataType.description, resync);
+				AddLaneTabularText(frame, text);
+				return;
+			}
+
+			AddResultString("DI [", number_str, "]");
+
+			/* Show data type and description. */
+			snprintf(text, sizeof(text), "VC [%s]  DT [%s] = %s", number_str_VC, number_str_DT, dataType.description);
+			AddResultString(text);
+
+			/* Show data type, description, and number of parameters (if applicable). */
+			if (dataType.parameters >= 0) {
+				snprintf(text, sizeof(text), "VC [%s]  DT [%s] = %s (%d parameters)", number_str_VC, number_str_DT, dataType.description, dataType.parameters);
+			}
+			AddResultString(text, resync);
+		} else {
+		/* Data Type is unknown. */
+			if (tabular) {
+				snprintf(text, sizeof(text), "DI [%s] VC [%s] DT [%s]", number_str, number_str_VC, number_str_DT);
+				AddLaneTabularText(frame, text);
+				return;
+			}
+
+			AddResultString("DI [", number_str, "]");
+			AddResultString("VC [", number_str_VC, "] DT [", number_str_DT, "]");
+			AddResultString("Virtual Channel [", number_str_VC, "] Data Type [", number_str_DT, "]");
+		}
+		return;
+	}
+
+	/* ECC byte of a damaged header, or last checksum byte of a corrupt long packet. */
+	if (frame.mFlags & PACKET_FLAG_ECC_ERROR) {
+		verdict = " ECC error";
+	} else if (frame.mFlags & PACKET_FLAG_ECC_CORRECTED) {
+		verdict = " ECC corrected";
+	} else if (frame.mFlags & PACKET_FLAG_CRC_ERROR) {
+		verdict = " CRC error";
+	}
+
+	/* Payload bytes count from the end of the header. */
+	if (role == BYTE_ROLE_PAYLOAD) {
+		snprintf(text, sizeof(text), "Payload %u [%s]%s", BYTE_INDEX(frame.mData2) - DSI_HEADER_LENGTH, number_str, verdict);
+	} else {
+		snprintf(text, sizeof(text), "%s [%s]%s", DSI_byteRoleNames[role], number_str, verdict);
+	}
+
+	/* The other bytes name the packet they belong to, from its DI (corrected once the ECC is in). */
+	U8 di = BYTE_DI(frame.mData2);
+	AnalyzerHelpers::GetNumberString(DSI_GetVirtualChannel(di), display_base, 2, number_str_VC, 16);
+	AnalyzerHelpers::GetNumberString(DSI_GetDataType(di), display_base, 6, number_str_DT, 16);
+	snprintf(packet_str, sizeof(packet_str), " (VC [%s] DT [%s])", number_str_VC, number_str_DT);
+
+	if (tabular) {
+		char row[sizeof(text) + sizeof(packet_str)];
+		snprintf(row, sizeof(row), "%s%s", text, packet_str);
+		AddLaneTabularText(frame, row);
+		return;
+	}
+
+	/* Bubble strings, shortest first. */
+	AddResultString(number_str);
+	if (verdict[0] != '\0') {
+		AddResultString(number_str, verdict);
+	}
+	AddResultString(text);
+	AddResultString(text, packet_str);
+}
+
+void MIPI_DSI_LP_AnalyzerResults::AddLaneTabularText(const Frame& frame, const char* text)
+{
+	if (mMultiLane) {
+		char lane_str[16];
+		snprintf(lane_str, sizeof(lane_str), "Lane %u: ", FRAME_LANE(frame.mFlags));
+		AddTabularText(lane_str, text);
+	} else {
+		AddTabularText(text);
+	}
+}
+
+U64 MIPI_DSI_LP_AnalyzerResults::AddPayload(const U8* data, U32 length)
+{
+	std::lock_guard<std::mutex> lock(mPayloadMutex);
+	U64 offset = mPayload.size();
+
+	mPayload.insert(mPayload.end(), data, data + length);
+	return offset;
+}
+
+void MIPI_DSI_LP_AnalyzerResults::GetPayload(U64 offset, U8* data, U32 length)
+{
+	std::lock_guard<std::mutex> lock(mPayloadMutex);
+
+	memcpy(data, &mPayload[offset], length);
 }
@@ -2,9 +2,65 @@
 #define MIPI_DSI_LP__ANALYZER_RESULTS
 
 #include <AnalyzerResults.h>
+#include "MIPI_DSI_LP_Framebuffer.h"
+#include <vector>
+#include <string>
+#include <mutex>
+
+/* Frame types stored in Frame::mType[2:0]. */
+enum MIPI_DSI_LP_FrameType
+{
+	FRAME_TYPE_BYTE = 0,	/* One LPDT byte. mData1 = byte, mData2 = byte index, role and packet DI. */
+	FRAME_TYPE_PACKET,		/* One DSI packet. mData1 = packed header/checksum, mData2 = payload reference. */
+	FRAME_TYPE_ESCAPE,		/* Entry command other than LPDT. mData1 = entry byte, mData2 = DSI_EscapeCommand. */
+	FRAME_TYPE_TURNAROUND	/* Bus turnaround. FRAME_TYPE_REVERSE is set when it hands the bus to the peripheral. */
+};
+/* Frame::mType[7]: sent by the peripheral, after a bus turnaround. */
+#define FRAME_TYPE_REVERSE		0x80
+/* Frame::mType[3]: expected from the peripheral, but a host data type: the decoder fell back to host direction. */
+#define FRAME_TYPE_RESYNC		0x08
+#define FRAME_KIND(type)		U8((type) & 0x07)
+/* Frame::mType[6:4]: DSI_DataTypeClass of the packet, for byte and packet frames. */
+#define FRAME_TYPE_CLASS_SHIFT	4
+#define FRAME_TYPE_CLASS_MASK	( 7 << FRAME_TYPE_CLASS_SHIFT )
+#define FRAME_TYPE_CLASS(dtClass)	U8(((dtClass) << FRAME_TYPE_CLASS_SHIFT) & FRAME_TYPE_CLASS_MASK)
+#define FRAME_CLASS(type)		U8(((type) & FRAME_TYPE_CLASS_MASK) >> FRAME_TYPE_CLASS_SHIFT)
+
+/* Byte frame mData2: index within its packet[31:0], DI of the packet[39:32], byte role[43:40]. */
+enum MIPI_DSI_LP_ByteRole
+{
+	BYTE_ROLE_DI = 0,
+	BYTE_ROLE_DATA,			/* Data 0 or data 1 of a short packet. */
+	BYTE_ROLE_WORD_COUNT,	/* Word count of a long packet. */
+	BYTE_ROLE_ECC,
+	BYTE_ROLE_PAYLOAD,
+	BYTE_ROLE_CHECKSUM
+};
+#define BYTE_DATA2(index, di, role)	(U64(index) | (U64(di) << 32U) | (U64(role) << 40U))
+#define BYTE_INDEX(data2)			U32((data2) & 0xFFFFFFFF)
+#define BYTE_DI(data2)				U8(((data2) >> 32U) & 0xFF)
+#define BYTE_ROLE(data2)			U8(((data2) >> 40U) & 0x0F)
+
+/* Packet frame mData1: DI[7:0], data 0[15:8], data 1[23:16], ECC[31:24], checksum[47:32]. */
+#define PACKET_HEADER_BYTE(data1, index)	U8(((data1) >> (8U * (index))) & 0xFF)
+#define PACKET_CHECKSUM(data1)				U16(((data1) >> 32U) & 0xFFFF)
+/* Packet frame mData2: payload offset[47:0], payload bytes stored[63:48]. */
+#define PACKET_PAYLOAD_OFFSET(data2)		((data2) & 0xFFFFFFFFFFFFULL)
+#define PACKET_PAYLOAD_LENGTH(data2)		U32((data2) >> 48U)
+
+/* Frame flags, next to the SDK's DISPLAY_AS_* flags. */
+#define PACKET_FLAG_TRUNCATED		( 1 << 0 )	/* Burst ended before the packet did. */
+#define PACKET_FLAG_ECC_CORRECTED	( 1 << 1 )	/* Header had a single-bit error, corrected. */
+#define PACKET_FLAG_ECC_ERROR		( 1 << 2 )	/* Header has an uncorrectable ECC error. */
+#define PACKET_FLAG_CRC_ERROR		( 1 << 3 )	/* Long packet checksum doesn't match its payload. */
+/* Data lane of the frame, in flags [5:4]. */
+#define FRAME_LANE_SHIFT			4
+#define FRAME_LANE_MASK				( 3 << FRAME_LANE_SHIFT )
+#define FRAME_LANE(flags)			U32(((flags) & FRAME_LANE_MASK) >> FRAME_LANE_SHIFT)
 
 class MIPI_DSI_LP_Analyzer;
 class MIPI_DSI_LP_AnalyzerSettings;
+class MIPI_DSI_LP_ExportWriter;
 
 class MIPI_DSI_LP_AnalyzerResults : public AnalyzerResults
 {
@@ -19,12 +75,49 @@ public:
 	virtual void GeneratePacketTabularText( U64 packet_id, DisplayBase display_base );
 	virtual void GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base );
 
+	U64 AddPayload(const U8* data, U32 length);
+	void GetPayload(U64 offset, U8* data, U32 length);
+
 protected: //functions
+	void GeneratePacketText(const Frame& frame, DisplayBase display_base, bool tabular);
+	void AddPacketTabularText(U64 packet_id, DisplayBase display_base);
+	void GenerateEscapeText(const Frame& frame, DisplayBase display_base, bool tabular);
+	void GenerateByteText(const Frame& frame, DisplayBase display_base, bool tabular);
+	void AddLaneTabularText(const Frame& frame, const char* text);
+	U64 SampleToNanoseconds(U64 sample);
+	void ExportFrames(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base);
+	/* An export that goes over the packets more than once reports each pass as its share of the progress. */
+	bool ExportPackets(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base, U32 export_type, U32 pass = 0, U32 passes = 1);
+	void ExportPixels(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base);
+	void WritePacket(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count, DisplayBase display_base, U32 export_type);
+	void WritePacketRow(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count, DisplayBase display_base);
+	void WritePacketJson(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count);
+	void WritePixelRow(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count);
+	void ExportFramebuffer(MIPI_DSI_LP_ExportWriter& writer, DisplayBase display_base, const char* file);
+	void AddFramebufferPacket(const Frame& frame, const U8* bytes, U32 count);
+	void WriteFramebufferSnapshot(void);
+	void WritePcapngHeader(MIPI_DSI_LP_ExportWriter& writer);
+	void WritePcapngBlock(MIPI_DSI_LP_ExportWriter& writer, const Frame& frame, const U8* bytes, U32 count);
 
 protected:  //vars
 	MIPI_DSI_LP_AnalyzerSettings* mSettings;
 	MIPI_DSI_LP_Analyzer* mAnalyzer;
-	uint32_t DSI_packetsCount;
+	bool mMultiLane;	/* More than one lane in use: frames name their lane. */
+
+	/* Payload bytes of packet frames, appended by the worker and read by the UI. */
+	std::vector<U8> mPayload;
+	std::mutex mPayloadMutex;
+
+	/* Pixel export: image size from the first pass, and the row being unpacked. */
+	U32 mPixelWidth;
+	U64 mPixelRows;
+	bool mPixelScan;
+	std::vector<U8> mPixelRow;
+
+	/* Framebuffer export: panel frame memory rebuilt from DCS writes, and the numbered files it goes to. */
+	MIPI_DSI_LP_Framebuffer mFramebuffer;
+	std::string mFramebufferFile;
+	U32 mFramebufferCount;
 };
 
 #endif //MIPI_DSI_LP__ANALYZER_RESULTS
@@ -1,23 +1,151 @@
 #include "MIPI_DSI_LP_AnalyzerSettings.h"
 #include <AnalyzerHelpers.h>
 
+/* Channel labels of every lane. */
+static const char* laneLabels[DSI_LANE_COUNT][2][2] =
+{
+	/* { setting title, channel label } for D+ and D- */
+	{ { "DATA+", "D+" }, { "DATA-", "D-" } },
+	{ { "Lane 1 DATA+", "D1+" }, { "Lane 1 DATA-", "D1-" } },
+	{ { "Lane 2 DATA+", "D2+" }, { "Lane 2 DATA-", "D2-" } },
+	{ { "Lane 3 DATA+", "D3+" }, { "Lane 3 DATA-", "D3-" } }
+};
+
+/* { setting title, tooltip } of every simulation fault rate. */
+static const char* simFaultLabels[SIM_FAULT_COUNT][2] =
+{
+	{ "Simulation glitches (per mille)", "Chance per burst of a short pulse on D+ or D- during a space." },
+	{ "Simulation stretched bits (per mille)", "Chance per burst of a bit held past the decoder timeout." },
+	{ "Simulation truncated packets (per mille)", "Chance per burst of a stop in the middle of the packet." },
+	{ "Simulation entry errors (per mille)", "Chance per burst of a broken escape mode entry: long bridge, D+ high during the entry pulse, or a wrong entry command." },
+	{ "Simulation contention (per mille)", "Chance per burst of both lines changing together, or of a stop starting on D-." }
+};
+
 MIPI_DSI_LP_AnalyzerSettings::MIPI_DSI_LP_AnalyzerSettings()
-:	mPosChannel(UNDEFINED_CHANNEL), mNegChannel(UNDEFINED_CHANNEL)
+:	mMarkerDensity(MARKERS_PER_BIT),
+	mFrameMode(FRAMES_PER_BYTE),
+	mTimeoutRatio(5),
+	mGlitchFilter(0),
+	mSimBitRate(1000),
+	mSimLongPackets(25),
+	mSimPayloadLength(64),
+	mSimIdleGap(20),
+	mSimSeed(0)
 {
-	mSettingChannelP.reset(new AnalyzerSettingInterfaceChannel());
-	mSettingChannelP->SetTitleAndTooltip( "DATA+", "" );
-	mSettingChannelP->SetChannel(mPosChannel);
+	/* Lane 0 is required, lanes 1 to 3 are optional. */
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		mPosChannel[i] = UNDEFINED_CHANNEL;
+		mNegChannel[i] = UNDEFINED_CHANNEL;
 
-	mSettingChannelN.reset(new AnalyzerSettingInterfaceChannel());
-	mSettingChannelN->SetTitleAndTooltip("DATA-", "");
-	mSettingChannelN->SetChannel(mNegChannel);
+		mSettingChannelP[i].reset(new AnalyzerSettingInterfaceChannel());
+		mSettingChannelP[i]->SetTitleAndTooltip(laneLabels[i][0][0], "");
+		mSettingChannelP[i]->SetChannel(mPosChannel[i]);
+		mSettingChannelP[i]->SetSelectionOfNoneIsAllowed(i > 0);
 
-	AddInterface(mSettingChannelP.get());
-	AddInterface(mSettingChannelN.get());
+		mSettingChannelN[i].reset(new AnalyzerSettingInterfaceChannel());
+		mSettingChannelN[i]->SetTitleAndTooltip(laneLabels[i][1][0], "");
+		mSettingChannelN[i]->SetChannel(mNegChannel[i]);
+		mSettingChannelN[i]->SetSelectionOfNoneIsAllowed(i > 0);
+	}
 
-	ClearChannels();
-	AddChannel(mPosChannel, "D+", false);
-	AddChannel(mNegChannel, "D-", false);
+	mSettingMarkerDensity.reset(new AnalyzerSettingInterfaceNumberList());
+	mSettingMarkerDensity->SetTitleAndTooltip("Markers", "Amount of markers placed on the waveform. Fewer markers keep long captures responsive.");
+	mSettingMarkerDensity->AddNumber(MARKERS_PER_BIT, "Every bit", "Start, stop, every bit and errors.");
+	mSettingMarkerDensity->AddNumber(MARKERS_PER_BYTE, "Every byte", "Start, stop, byte boundaries and errors.");
+	mSettingMarkerDensity->AddNumber(MARKERS_ERRORS_ONLY, "Errors only", "Only error markers.");
+	mSettingMarkerDensity->AddNumber(MARKERS_NONE, "None", "No markers.");
+	mSettingMarkerDensity->SetNumber(mMarkerDensity);
+
+	mSettingFrameMode.reset(new AnalyzerSettingInterfaceNumberList());
+	mSettingFrameMode->SetTitleAndTooltip("Frames", "What a single decoded frame stands for.");
+	mSettingFrameMode->AddNumber(FRAMES_PER_BYTE, "One per byte", "Every LPDT byte is a frame, grouped into packets.");
+	mSettingFrameMode->AddNumber(FRAMES_PER_PACKET, "One per packet", "Every DSI packet is a single frame with its header decoded.");
+	mSettingFrameMode->SetNumber(mFrameMode);
+
+	mSettingTimeoutRatio.reset(new AnalyzerSettingInterfaceInteger());
+	mSettingTimeoutRatio->SetTitleAndTooltip("Timeout (pulse lengths)", "How long a line state may last, in average LP pulse lengths, before the burst is given up.");
+	mSettingTimeoutRatio->SetMin(2);
+	mSettingTimeoutRatio->SetMax(100);
+	mSettingTimeoutRatio->SetInteger(mTimeoutRatio);
+
+	mSettingGlitchFilter.reset(new AnalyzerSettingInterfaceInteger());
+	mSettingGlitchFilter->SetTitleAndTooltip("Glitch filter (samples)", "Pulses on D+ or D- shorter than this many samples are ignored. 0 turns the filter off.");
+	mSettingGlitchFilter->SetMin(0);
+	mSettingGlitchFilter->SetMax(1000);
+	mSettingGlitchFilter->SetInteger(mGlitchFilter);
+
+	mSettingSimBitRate.reset(new AnalyzerSettingInterfaceInteger());
+	mSettingSimBitRate->SetTitleAndTooltip("Simulation bit rate (kbit/s)", "LPDT bit rate of the simulated traffic. Limited by the simulation sample rate.");
+	mSettingSimBitRate->SetMin(1);
+	mSettingSimBitRate->SetMax(20000);
+	mSettingSimBitRate->SetInteger(mSimBitRate);
+
+	mSettingSimLongPackets.reset(new AnalyzerSettingInterfaceInteger());
+	mSettingSimLongPackets->SetTitleAndTooltip("Simulation long packets (%)", "Share of long packets in the simulated traffic, the rest are short packets.");
+	mSettingSimLongPackets->SetMin(0);
+	mSettingSimLongPackets->SetMax(100);
+	mSettingSimLongPackets->SetInteger(mSimLongPackets);
+
+	mSettingSimPayloadLength.reset(new AnalyzerSettingInterfaceInteger());
+	mSettingSimPayloadLength->SetTitleAndTooltip("Simulation payload (bytes)", "Longest payload of a simulated long packet.");
+	mSettingSimPayloadLength->SetMin(1);
+	mSettingSimPayloadLength->SetMax(0xFFFF);
+	mSettingSimPayloadLength->SetInteger(mSimPayloadLength);
+
+	mSettingSimIdleGap.reset(new AnalyzerSettingInterfaceInteger());
+	mSettingSimIdleGap->SetTitleAndTooltip("Simulation idle gap (bits)", "Stop state between simulated bursts, in bit periods.");
+	mSettingSimIdleGap->SetMin(1);
+	mSettingSimIdleGap->SetMax(1000000);
+	mSettingSimIdleGap->SetInteger(mSimIdleGap);
+
+	mSettingSimSeed.reset(new AnalyzerSettingInterfaceInteger());
+	mSettingSimSeed->SetTitleAndTooltip("Simulation seed", "Same seed, same simulated traffic and faults.");
+	mSettingSimSeed->SetMin(0);
+	mSettingSimSeed->SetMax(0x7FFFFFFF);
+	mSettingSimSeed->SetInteger(mSimSeed);
+
+	/* Simulated traffic is clean unless asked otherwise. */
+	for (U32 i = 0; i < SIM_FAULT_COUNT; i++) {
+		mSimFaultRate[i] = 0;
+
+		mSettingSimFaultRate[i].reset(new AnalyzerSettingInterfaceInteger());
+		mSettingSimFaultRate[i]->SetTitleAndTooltip(simFaultLabels[i][0], simFaultLabels[i][1]);
+		mSettingSimFaultRate[i]->SetMin(0);
+		mSettingSimFaultRate[i]->SetMax(1000);
+		mSettingSimFaultRate[i]->SetInteger(mSimFaultRate[i]);
+	}
+
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		AddInterface(mSettingChannelP[i].get());
+		AddInterface(mSettingChannelN[i].get());
+	}
+	AddInterface(mSettingMarkerDensity.get());
+	AddInterface(mSettingFrameMode.get());
+	AddInterface(mSettingTimeoutRatio.get());
+	AddInterface(mSettingGlitchFilter.get());
+	AddInterface(mSettingSimBitRate.get());
+	AddInterface(mSettingSimLongPackets.get());
+	AddInterface(mSettingSimPayloadLength.get());
+	AddInterface(mSettingSimIdleGap.get());
+	AddInterface(mSettingSimSeed.get());
+	for (U32 i = 0; i < SIM_FAULT_COUNT; i++) {
+		AddInterface(mSettingSimFaultRate[i].get());
+	}
+
+	AddExportOption(EXPORT_FRAMES, "Export frames as text/csv file");
+	AddExportExtension(EXPORT_FRAMES, "csv", "csv");
+	AddExportOption(EXPORT_PACKETS, "Export packets as text/csv file");
+	AddExportExtension(EXPORT_PACKETS, "csv", "csv");
+	AddExportOption(EXPORT_PCAPNG, "Export packets as pcapng file");
+	AddExportExtension(EXPORT_PCAPNG, "pcapng", "pcapng");
+	AddExportOption(EXPORT_NDJSON, "Export packets as NDJSON file");
+	AddExportExtension(EXPORT_NDJSON, "ndjson", "ndjson");
+	AddExportOption(EXPORT_PIXELS, "Export pixel streams as PPM image");
+	AddExportExtension(EXPORT_PIXELS, "ppm", "ppm");
+	AddExportOption(EXPORT_FRAMEBUFFER, "Export DCS frame memory as numbered PPM images");
+	AddExportExtension(EXPORT_FRAMEBUFFER, "ppm", "ppm");
+
+	UpdateChannels(false);
 }
 
 MIPI_DSI_LP_AnalyzerSettings::~MIPI_DSI_LP_AnalyzerSettings()
@@ -26,26 +154,72 @@ MIPI_DSI_LP_AnalyzerSettings::~MIPI_DSI_LP_AnalyzerSettings()
 
 bool MIPI_DSI_LP_AnalyzerSettings::SetSettingsFromInterfaces()
 {
-	mPosChannel = mSettingChannelP->GetChannel();
-	mNegChannel = mSettingChannelN->GetChannel();
+	Channel pos[DSI_LANE_COUNT], neg[DSI_LANE_COUNT];
+
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		pos[i] = mSettingChannelP[i]->GetChannel();
+		neg[i] = mSettingChannelN[i]->GetChannel();
 
-	if (mPosChannel == mNegChannel)
-	{
-		SetErrorText("D+ and D- can't be assigned to the same input.");
-		return false;
+		/* A lane needs both of its lines. */
+		if ((pos[i] == UNDEFINED_CHANNEL) != (neg[i] == UNDEFINED_CHANNEL)) {
+			SetErrorText("Every lane in use needs both D+ and D- assigned.");
+			return false;
+		}
 	}
 
-	ClearChannels();
-	AddChannel(mPosChannel, "D+", true);
-	AddChannel(mNegChannel, "D-", true);
+	/* No input can serve two lines. */
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		if (pos[i] == UNDEFINED_CHANNEL) {
+			continue;
+		}
+		for (U32 j = 0; j < DSI_LANE_COUNT; j++) {
+			if ((pos[i] == neg[j]) || ((j > i) && ((pos[i] == pos[j]) || (neg[i] == neg[j])))) {
+				SetErrorText("D+ and D- can't be assigned to the same input.");
+				return false;
+			}
+		}
+	}
+
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		mPosChannel[i] = pos[i];
+		mNegChannel[i] = neg[i];
+	}
+	mMarkerDensity = U32(mSettingMarkerDensity->GetNumber());
+	mFrameMode = U32(mSettingFrameMode->GetNumber());
+	mTimeoutRatio = U32(mSettingTimeoutRatio->GetInteger());
+	mGlitchFilter = U32(mSettingGlitchFilter->GetInteger());
+	mSimBitRate = U32(mSettingSimBitRate->GetInteger());
+	mSimLongPackets = U32(mSettingSimLongPackets->GetInteger());
+	mSimPayloadLength = U32(mSettingSimPayloadLength->GetInteger());
+	mSimIdleGap = U32(mSettingSimIdleGap->GetInteger());
+	mSimSeed = U32(mSettingSimSeed->GetInteger());
+	for (U32 i = 0; i < SIM_FAULT_COUNT; i++) {
+		mSimFaultRate[i] = U32(mSettingSimFaultRate[i]->GetInteger());
+	}
+
+	UpdateChannels(true);
 
 	return true;
 }
 
 void MIPI_DSI_LP_AnalyzerSettings::UpdateInterfacesFromSettings()
 {
-	mSettingChannelP->SetChannel(mPosChannel);
-	mSettingChannelN->SetChannel(mNegChannel);
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		mSettingChannelP[i]->SetChannel(mPosChannel[i]);
+		mSettingChannelN[i]->SetChannel(mNegChannel[i]);
+	}
+	mSettingMarkerDensity->SetNumber(mMarkerDensity);
+	mSettingFrameMode->SetNumber(mFrameMode);
+	mSettingTimeoutRatio->SetInteger(mTimeoutRatio);
+	mSettingGlitchFilter->SetInteger(mGlitchFilter);
+	mSettingSimBitRate->SetInteger(mSimBitRate);
+	mSettingSimLongPackets->SetInteger(mSimLongPackets);
+	mSettingSimPayloadLength->SetInteger(mSimPayloadLength);
+	mSettingSimIdleGap->SetInteger(mSimIdleGap);
+	mSettingSimSeed->SetInteger(mSimSeed);
+	for (U32 i = 0; i < SIM_FAULT_COUNT; i++) {
+		mSettingSimFaultRate[i]->SetInteger(mSimFaultRate[i]);
+	}
 }
 
 void MIPI_DSI_LP_AnalyzerSettings::LoadSettings( const char* settings )
@@ -58,12 +232,29 @@ void MIPI_DSI_LP_AnalyzerSettings::LoadSettings( const char* settings )
 	if (strcmp(name_string, "Saleae_MIPI_DSI_LP_Analyzer") != 0)
 		AnalyzerHelpers::Assert("Saleae_MIPI_DSI_LP_Analyzer: Provided with a settings string that doesn't belong to us;");
 
-	text_archive >> mPosChannel;
-	text_archive >> mNegChannel;
+	text_archive >> mPosChannel[0];
+	text_archive >> mNegChannel[0];
+	/* Settings saved by older versions end here. */
+	if (!(text_archive >> mMarkerDensity)) mMarkerDensity = MARKERS_PER_BIT;
+	if (!(text_archive >> mFrameMode)) mFrameMode = FRAMES_PER_BYTE;
+	if (!(text_archive >> mTimeoutRatio)) mTimeoutRatio = 5;
+	if (!(text_archive >> mGlitchFilter)) mGlitchFilter = 0;
+	for (U32 i = 1; i < DSI_LANE_COUNT; i++) {
+		if (!(text_archive >> mPosChannel[i]) || !(text_archive >> mNegChannel[i])) {
+			mPosChannel[i] = UNDEFINED_CHANNEL;
+			mNegChannel[i] = UNDEFINED_CHANNEL;
+		}
+	}
+	if (!(text_archive >> mSimBitRate)) mSimBitRate = 1000;
+	if (!(text_archive >> mSimLongPackets)) mSimLongPackets = 25;
+	if (!(text_archive >> mSimPayloadLength)) mSimPayloadLength = 64;
+	if (!(text_archive >> mSimIdleGap)) mSimIdleGap = 20;
+	if (!(text_archive >> mSimSeed)) mSimSeed = 0;
+	for (U32 i = 0; i < SIM_FAULT_COUNT; i++) {
+		if (!(text_archive >> mSimFaultRate[i])) mSimFaultRate[i] = 0;
+	}
 
-	ClearChannels();
-	AddChannel(mPosChannel, "D+", true);
-	AddChannel(mNegChannel, "D-", true);
+	UpdateChannels(true);
 
 	UpdateInterfacesFromSettings();
 }
@@ -73,8 +264,35 @@ const char* MIPI_DSI_LP_AnalyzerSettings::SaveSettings()
 	SimpleArchive text_archive;
 
 	text_archive << "Saleae_MIPI_DSI_LP_Analyzer";
-	text_archive << mPosChannel;
-	text_archive << mNegChannel;
+	text_archive << mPosChannel[0];
+	text_archive << mNegChannel[0];
+	text_archive << mMarkerDensity;
+	text_archive << mFrameMode;
+	text_archive << mTimeoutRatio;
+	text_archive << mGlitchFilter;
+	for (U32 i = 1; i < DSI_LANE_COUNT; i++) {
+		text_archive << mPosChannel[i];
+		text_archive << mNegChannel[i];
+	}
+	text_archive << mSimBitRate;
+	text_archive << mSimLongPackets;
+	text_archive << mSimPayloadLength;
+	text_archive << mSimIdleGap;
+	text_archive << mSimSeed;
+	for (U32 i = 0; i < SIM_FAULT_COUNT; i++) {
+		text_archive << mSimFaultRate[i];
+	}
 
 	return SetReturnString(text_archive.GetString());
 }
+
+void MIPI_DSI_LP_AnalyzerSettings::UpdateChannels(bool used)
+{
+	ClearChannels();
+	for (U32 i = 0; i < DSI_LANE_COUNT; i++) {
+		/* Optional lanes only count once they are assigned. */
+		bool laneUsed = used && ((i == 0) || (mPosChannel[i] != UNDEFINED_CHANNEL));
+		AddChannel(mPosChannel[i], laneLabels[i][0][1], laneUsed);
+		AddChannel(mNegChannel[i], laneLabels[i][1][1], laneUsed);
+	}
+}
@@ -4,6 +4,47 @@
 #include <AnalyzerSettings.h>
 #include <AnalyzerTypes.h>
 
+/* How many markers the analyzer puts on the waveform. */
+enum MarkerDensity
+{
+	MARKERS_PER_BIT = 0,	/* Start/stop, every bit and errors. */
+	MARKERS_PER_BYTE,		/* Start/stop, byte boundaries and errors. */
+	MARKERS_ERRORS_ONLY,	/* Errors only. */
+	MARKERS_NONE			/* No markers at all. */
+};
+
+/* What a single frame stands for. */
+enum FrameMode
+{
+	FRAMES_PER_BYTE = 0,	/* One frame per LPDT byte. */
+	FRAMES_PER_PACKET		/* One frame per DSI packet. */
+};
+
+/* Export file formats, by export_type_user_id. */
+enum ExportType
+{
+	EXPORT_FRAMES = 0,		/* CSV, one row per frame. */
+	EXPORT_PACKETS,			/* CSV, one row per DSI packet with its header decoded. */
+	EXPORT_PCAPNG,			/* pcapng, one enhanced packet block per DSI packet. */
+	EXPORT_NDJSON,			/* Newline-delimited JSON, one object per DSI packet. */
+	EXPORT_PIXELS,			/* PPM image, one RGB888 row per pixel stream packet. */
+	EXPORT_FRAMEBUFFER		/* PPM files <name>_0000.ppm on, one per frame drawn with DCS memory writes. */
+};
+
+/* Faults the simulation can inject into a burst. */
+enum SimFault
+{
+	SIM_FAULT_GLITCH = 0,	/* Short pulse on D+ or D- during a space. */
+	SIM_FAULT_STRETCH,		/* Bit held past the decoder timeout. */
+	SIM_FAULT_TRUNCATE,		/* Burst stopped in the middle of the packet. */
+	SIM_FAULT_ENTRY,		/* Broken escape mode entry. */
+	SIM_FAULT_CONTENTION,	/* Both lines change together, or the stop starts on D-. */
+	SIM_FAULT_COUNT
+};
+
+/* Data lanes a single analyzer decodes. */
+#define DSI_LANE_COUNT	4U
+
 class MIPI_DSI_LP_AnalyzerSettings : public AnalyzerSettings
 {
 public:
@@ -15,10 +56,34 @@ public:
 	virtual void LoadSettings( const char* settings );
 	virtual const char* SaveSettings();
 
-	Channel mPosChannel, mNegChannel;
+	Channel mPosChannel[DSI_LANE_COUNT], mNegChannel[DSI_LANE_COUNT];
+	U32 mMarkerDensity;
+	U32 mFrameMode;
+	U32 mTimeoutRatio;
+	U32 mGlitchFilter;
+
+	/* Simulated traffic. */
+	U32 mSimBitRate;		/* LPDT bit rate, kbit/s. */
+	U32 mSimLongPackets;	/* Share of long packets, percent. */
+	U32 mSimPayloadLength;	/* Longest long packet payload, bytes. */
+	U32 mSimIdleGap;		/* LP-11 between bursts, bit periods. */
+	U32 mSimSeed;			/* Seed of the traffic and fault generator. */
+	U32 mSimFaultRate[SIM_FAULT_COUNT];	/* Chance of each fault per burst, per mille. */
 
 protected:
-	std::auto_ptr<AnalyzerSettingInterfaceChannel> mSettingChannelP, mSettingChannelN;
+	void UpdateChannels(bool used);
+
+	std::auto_ptr<AnalyzerSettingInterfaceChannel> mSettingChannelP[DSI_LANE_COUNT], mSettingChannelN[DSI_LANE_COUNT];
+	std::auto_ptr<AnalyzerSettingInterfaceNumberList> mSettingMarkerDensity;
+	std::auto_ptr<AnalyzerSettingInterfaceNumberList> mSettingFrameMode;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingTimeoutRatio;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingGlitchFilter;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingSimBitRate;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingSimLongPackets;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingSimPayloadLength;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingSimIdleGap;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingSimSeed;
+	std::auto_ptr<AnalyzerSettingInterfaceInteger> mSettingSimFaultRate[SIM_FAULT_COUNT];
 };
 
 #endif //MIPI_DSI_LP__ANALYZER_SETTINGS
@@ -0,0 +1,79 @@
+#include "MIPI_DSI_LP_ExportWriter.h"
+#include <AnalyzerHelpers.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+MIPI_DSI_LP_ExportWriter::MIPI_DSI_LP_ExportWriter()
+:	mFile( NULL ),
+	mLength( 0 )
+{
+}
+
+MIPI_DSI_LP_ExportWriter::~MIPI_DSI_LP_ExportWriter()
+{
+	Close();
+}
+
+bool MIPI_DSI_LP_ExportWriter::Open(const char* file, bool isBinary)
+{
+	Close();
+	mFile = AnalyzerHelpers::StartFile(file, isBinary);
+	mBuffer.resize(EXPORT_BUFFER_SIZE);
+	mLength = 0;
+	return mFile != NULL;
+}
+
+void MIPI_DSI_LP_ExportWriter::Close(void)
+{
+	if (mFile != NULL) {
+		Flush();
+		AnalyzerHelpers::EndFile(mFile);
+		mFile = NULL;
+	}
+}
+
+void MIPI_DSI_LP_ExportWriter::Flush(void)
+{
+	if (mLength > 0) {
+		AnalyzerHelpers::AppendToFile(&mBuffer[0], mLength, mFile);
+		mLength = 0;
+	}
+}
+
+void MIPI_DSI_LP_ExportWriter::Write(const void* data, U32 length)
+{
+	if (mFile == NULL) {
+		return;
+	}
+
+	if ((mLength + U64(length)) > mBuffer.size()) {
+		Flush();
+		/* Too big to buffer: straight to the file. */
+		if (length > mBuffer.size()) {
+			AnalyzerHelpers::AppendToFile(static_cast<const U8*>(data), length, mFile);
+			return;
+		}
+	}
+	memcpy(&mBuffer[mLength], data, length);
+	mLength += length;
+}
+
+void MIPI_DSI_LP_ExportWriter::Print(const char* text)
+{
+	Write(text, U32(strlen(text)));
+}
+
+void MIPI_DSI_LP_ExportWriter::Printf(const char* format, ...)
+{
+	char text[1024];
+	va_list args;
+
+	va_start(args, format);
+	int length = vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+
+	if (length > 0) {
+		Write(text, (length < int(sizeof(text))) ? U32(length) : U32(sizeof(text) - 1));
+	}
+}
@@ -0,0 +1,32 @@
+#ifndef MIPI_DSI_LP__EXPORT_WRITER_H
+#define MIPI_DSI_LP__EXPORT_WRITER_H
+
+#include <LogicPublicTypes.h>
+#include <vector>
+
+/* Export file output through AnalyzerHelpers::StartFile/AppendToFile, collected in one large buffer. */
+class MIPI_DSI_LP_ExportWriter
+{
+public:
+	MIPI_DSI_LP_ExportWriter();
+	~MIPI_DSI_LP_ExportWriter();
+
+	bool Open(const char* file, bool isBinary = false);
+	void Close(void);
+
+	void Write(const void* data, U32 length);
+	void Print(const char* text);
+	void Printf(const char* format, ...);
+
+protected:
+	void Flush(void);
+
+	/* Bytes collected before they go to the file. */
+	static const U32 EXPORT_BUFFER_SIZE = 1U << 20;
+
+	void* mFile;
+	std::vector<U8> mBuffer;
+	U32 mLength;
+};
+
+#endif //MIPI_DSI_LP__EXPORT_WRITER_H
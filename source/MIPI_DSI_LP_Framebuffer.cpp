@@ -0,0 +1,147 @@
+#include "MIPI_DSI_LP_Framebuffer.h"
+#include "MIPI_DSI_LP_Pixels.h"
+#include <string.h>
+
+MIPI_DSI_LP_Framebuffer::MIPI_DSI_LP_Framebuffer()
+{
+	Reset();
+}
+
+void MIPI_DSI_LP_Framebuffer::Reset(void)
+{
+	mImage.clear();
+	mWidth = 0;
+	mHeight = 0;
+	mDirty = false;
+	mPixelFormat = DCS_PIXEL_FORMAT_24BPP;
+	mColumnStart = mColumnEnd = 0;
+	mPageStart = mPageEnd = 0;
+	mWindowValid = false;
+	mX = mY = 0;
+	mCarryLength = 0;
+}
+
+void MIPI_DSI_LP_Framebuffer::AddCommand(U8 command, const U8* parameters, U32 length)
+{
+	bool columns = (command == DCS_SET_COLUMN_ADDRESS);
+
+	switch (command) {
+	case DCS_SET_COLUMN_ADDRESS:
+	case DCS_SET_PAGE_ADDRESS:
+		/* Start and end address, big-endian. */
+		if (length >= 4) {
+			U32 start = (U32(parameters[0]) << 8) | parameters[1];
+			U32 end = (U32(parameters[2]) << 8) | parameters[3];
+
+			if (columns) {
+				mColumnStart = start;
+				mColumnEnd = end;
+			} else {
+				mPageStart = start;
+				mPageEnd = end;
+			}
+			mWindowValid = (mColumnStart <= mColumnEnd) && (mColumnEnd < DCS_FRAMEBUFFER_MAX_SIDE) &&
+				(mPageStart <= mPageEnd) && (mPageEnd < DCS_FRAMEBUFFER_MAX_SIDE);
+		}
+		break;
+	case DCS_SET_PIXEL_FORMAT:
+		if (length >= 1) {
+			mPixelFormat = parameters[0] & 0x7;
+			mCarryLength = 0;
+		}
+		break;
+	case DCS_WRITE_MEMORY_START:
+		mX = mColumnStart;
+		mY = mPageStart;
+		mCarryLength = 0;
+		WritePixels(parameters, length);
+		break;
+	case DCS_WRITE_MEMORY_CONTINUE:
+		WritePixels(parameters, length);
+		break;
+	default:
+		break;
+	}
+}
+
+void MIPI_DSI_LP_Framebuffer::Resize(U32 width, U32 height)
+{
+	if ((width <= mWidth) && (height <= mHeight)) {
+		return;
+	}
+
+	/* Grow to cover the window, keeping what was drawn. */
+	U32 newWidth = (width > mWidth) ? width : mWidth;
+	U32 newHeight = (height > mHeight) ? height : mHeight;
+	std::vector<U8> image(size_t(newWidth) * newHeight * DSI_RGB_PIXEL_LENGTH, 0);
+
+	for (U32 y = 0; y < mHeight; y++) {
+		memcpy(&image[size_t(y) * newWidth * DSI_RGB_PIXEL_LENGTH], &mImage[size_t(y) * mWidth * DSI_RGB_PIXEL_LENGTH], mWidth * DSI_RGB_PIXEL_LENGTH);
+	}
+	mImage.swap(image);
+	mWidth = newWidth;
+	mHeight = newHeight;
+}
+
+void MIPI_DSI_LP_Framebuffer::WritePixels(const U8* data, U32 length)
+{
+	U32 pixelLength = DCS_GetPixelLength(mPixelFormat);
+
+	if (!mWindowValid || (pixelLength == 0) || (length == 0)) {
+		return;
+	}
+	Resize(mColumnEnd + 1, mPageEnd + 1);
+
+	/* The window moved away from the write position: start over at its top left corner. */
+	if ((mX < mColumnStart) || (mX > mColumnEnd) || (mY < mPageStart) || (mY > mPageEnd)) {
+		mX = mColumnStart;
+		mY = mPageStart;
+	}
+
+	/* Finish a pixel the previous write left open. */
+	if (mCarryLength > 0) {
+		while ((mCarryLength < pixelLength) && (mCarryLength < sizeof(mCarry)) && (length > 0)) {
+			mCarry[mCarryLength++] = *data++;
+			length--;
+		}
+		if (mCarryLength < pixelLength) {
+			return;
+		}
+		WriteSpan(mCarry, 1);
+		mCarryLength = 0;
+	}
+
+	/* Whole pixels, a window row at a time. */
+	U32 count = length / pixelLength;
+	while (count > 0) {
+		U32 span = mColumnEnd - mX + 1;
+		if (span > count) {
+			span = count;
+		}
+		WriteSpan(data, span);
+		data += span * pixelLength;
+		count -= span;
+	}
+
+	length %= pixelLength;
+	memcpy(mCarry, data, length);
+	mCarryLength = length;
+}
+
+void MIPI_DSI_LP_Framebuffer::WriteSpan(const U8* data, U32 count)
+{
+	U32 pixelLength = DCS_GetPixelLength(mPixelFormat);
+
+	DCS_UnpackPixels(mPixelFormat, data, count * pixelLength, &mImage[(size_t(mY) * mWidth + mX) * DSI_RGB_PIXEL_LENGTH]);
+	mDirty = true;
+
+	/* Left to right, top to bottom inside the window, wrapping around at its end. */
+	mX += count;
+	if (mX > mColumnEnd) {
+		mX = mColumnStart;
+		mY++;
+		if (mY > mPageEnd) {
+			mY = mPageStart;
+		}
+	}
+}
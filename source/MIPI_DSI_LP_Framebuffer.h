@@ -0,0 +1,59 @@
+#ifndef MIPI_DSI_LP__FRAMEBUFFER_H
+#define MIPI_DSI_LP__FRAMEBUFFER_H
+
+#include <LogicPublicTypes.h>
+#include <vector>
+#include "MIPI_DSI_LP_Pixels.h"
+
+/* DCS commands the framebuffer model follows. */
+#define DCS_SET_COLUMN_ADDRESS		0x2A
+#define DCS_SET_PAGE_ADDRESS		0x2B
+#define DCS_WRITE_MEMORY_START		0x2C
+#define DCS_SET_PIXEL_FORMAT		0x3A
+#define DCS_WRITE_MEMORY_CONTINUE	0x3C
+
+/* Largest frame memory modelled, in pixels per side. */
+#define DCS_FRAMEBUFFER_MAX_SIDE	4096U
+
+/* Panel frame memory rebuilt from DCS writes, kept as RGB888 rows. Memory writes land directly at their
+   address window, so every write only touches its own pixels. */
+class MIPI_DSI_LP_Framebuffer
+{
+public:
+	MIPI_DSI_LP_Framebuffer();
+
+	void Reset(void);
+
+	/* True if the command starts a new frame after pixels were written: time to take a snapshot. */
+	bool EndsFrame(U8 command) const { return (command == DCS_WRITE_MEMORY_START) && mDirty; }
+	/* Feeds one DCS write, command and parameters. */
+	void AddCommand(U8 command, const U8* parameters, U32 length);
+	/* Snapshot taken: the next pixels start a new frame. */
+	void ClearDirty(void) { mDirty = false; }
+
+	bool IsDirty() const { return mDirty; }
+	U32 GetWidth() const { return mWidth; }
+	U32 GetHeight() const { return mHeight; }
+	const U8* GetImage() const { return mImage.empty() ? NULL : &mImage[0]; }
+
+protected:
+	void Resize(U32 width, U32 height);
+	void WritePixels(const U8* data, U32 length);
+	void WriteSpan(const U8* data, U32 count);
+
+	std::vector<U8> mImage;	/* RGB888, mWidth * mHeight pixels. */
+	U32 mWidth, mHeight;
+	bool mDirty;			/* Pixels written since the last snapshot. */
+
+	U8 mPixelFormat;		/* DCS_PIXEL_FORMAT_* */
+	U32 mColumnStart, mColumnEnd;
+	U32 mPageStart, mPageEnd;
+	bool mWindowValid;		/* Both address ranges set, and inside DCS_FRAMEBUFFER_MAX_SIDE. */
+	U32 mX, mY;				/* Next pixel written. */
+
+	/* Bytes of a pixel split across two memory writes. */
+	U8 mCarry[DCS_MAX_PIXEL_LENGTH];
+	U32 mCarryLength;
+};
+
+#endif //MIPI_DSI_LP__FRAMEBUFFER_H
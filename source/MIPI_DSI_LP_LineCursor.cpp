@@ -0,0 +1,174 @@
+#include "MIPI_DSI_LP_LineCursor.h"
+
+MIPI_DSI_LP_LineCursor::MIPI_DSI_LP_LineCursor()
+:	mDataP(NULL), mDataN(NULL),
+	mNextP(0), mNextN(0),
+	mNextPKnown(false), mNextNKnown(false),
+	mQuietP(0), mQuietN(0),
+	mSample(0), mState(LP_11),
+	mMinPulseWidth(0)
+{
+}
+
+void MIPI_DSI_LP_LineCursor::Reset(AnalyzerChannelData* dataP, AnalyzerChannelData* dataN, U32 minPulseWidth)
+{
+	mDataP = dataP;
+	mDataN = dataN;
+	mMinPulseWidth = minPulseWidth;
+
+	/* Bring both lines to the same sample. */
+	mSample = mDataP->GetSampleNumber();
+	if (mDataN->GetSampleNumber() > mSample) {
+		mSample = mDataN->GetSampleNumber();
+	}
+	mDataP->AdvanceToAbsPosition(mSample);
+	mDataN->AdvanceToAbsPosition(mSample);
+
+	mState = ((mDataP->GetBitState() == BIT_HIGH) ? 2 : 0) | ((mDataN->GetBitState() == BIT_HIGH) ? 1 : 0);
+	mNextPKnown = false;
+	mNextNKnown = false;
+	mQuietP = mSample;
+	mQuietN = mSample;
+}
+
+void MIPI_DSI_LP_LineCursor::Refresh(AnalyzerChannelData* data, U64& next, bool& known)
+{
+	/* A line that may never change again must not block the other one. */
+	if (!known && data->DoMoreTransitionsExistInCurrentData()) {
+		AdvanceFiltered(data);
+		next = data->GetSampleNumber();
+		known = true;
+	}
+}
+
+void MIPI_DSI_LP_LineCursor::AdvanceFiltered(AnalyzerChannelData* data)
+{
+	/* The line is moved onto its next edge right away, the edge is reported once the other line has caught up. */
+	data->AdvanceToNextEdge();
+
+	/* A pulse shorter than the minimum width is swallowed together with the edge that ends it. */
+	while ((mMinPulseWidth > 1U) && data->WouldAdvancingCauseTransition(mMinPulseWidth - 1U)) {
+		data->AdvanceToNextEdge();
+		data->AdvanceToNextEdge();
+	}
+}
+
+void MIPI_DSI_LP_LineCursor::Next(LineEvent& event)
+{
+	Refresh(mDataP, mNextP, mNextPKnown);
+	Refresh(mDataN, mNextN, mNextNKnown);
+
+	/* Nothing buffered on either line: wait for more data on D-, then look at D+ again. */
+	if (!mNextPKnown && !mNextNKnown) {
+		AdvanceFiltered(mDataN);
+		mNextN = mDataN->GetSampleNumber();
+		mNextNKnown = true;
+		Refresh(mDataP, mNextP, mNextPKnown);
+	}
+
+	/* Take the earlier edge, or both if they coincide. */
+	bool advanceP = mNextPKnown && (!mNextNKnown || (mNextP <= mNextN));
+	bool advanceN = mNextNKnown && (!mNextPKnown || (mNextN <= mNextP));
+	U64 sample = advanceP ? mNextP : mNextN;
+
+	if (advanceP) {
+		mState ^= 2;
+		mNextPKnown = false;
+	}
+	if (advanceN) {
+		mState ^= 1;
+		mNextNKnown = false;
+	}
+
+	event.sample = sample;
+	event.duration = sample - mSample;
+	event.state = mState;
+	mSample = sample;
+}
+
+bool MIPI_DSI_LP_LineCursor::GetNextSample(U64& sample)
+{
+	/* True if Next() can return without waiting for more data, sample is then where its event will be. */
+	Refresh(mDataP, mNextP, mNextPKnown);
+	Refresh(mDataN, mNextN, mNextNKnown);
+
+	if (mNextPKnown && (!mNextNKnown || (mNextP <= mNextN))) {
+		sample = mNextP;
+		return true;
+	}
+	if (mNextNKnown) {
+		sample = mNextN;
+		return true;
+	}
+	return false;
+}
+
+bool MIPI_DSI_LP_LineCursor::WaitFor(U64 sample)
+{
+	/* True if an edge at or before sample turned up. Otherwise the capture has reached sample and both lines are quiet up to it. */
+	bool edge = false;
+
+	if (!mNextPKnown) {
+		if (mDataP->WouldAdvancingToAbsPositionCauseTransition(sample)) {
+			edge = true;
+		} else if (sample > mQuietP) {
+			mQuietP = sample;
+		}
+	}
+	if (!mNextNKnown) {
+		if (mDataN->WouldAdvancingToAbsPositionCauseTransition(sample)) {
+			edge = true;
+		} else if (sample > mQuietN) {
+			mQuietN = sample;
+		}
+	}
+	return edge;
+}
+
+U64 MIPI_DSI_LP_LineCursor::GetHorizon() const
+{
+	/* No event can come before this: the next edge of each line, or as far as it is known to be quiet. */
+	U64 p = mNextPKnown ? mNextP : ((mQuietP > mSample) ? mQuietP : mSample);
+	U64 n = mNextNKnown ? mNextN : ((mQuietN > mSample) ? mQuietN : mSample);
+
+	return (p < n) ? p : n;
+}
+
+void MIPI_DSI_LP_LineCursor::SkipToStop()
+{
+	U64 sample = mSample;
+
+	/* Edges already looked up are skipped too. */
+	if (mNextPKnown && (mNextP > sample)) {
+		sample = mNextP;
+	}
+	if (mNextNKnown && (mNextN > sample)) {
+		sample = mNextN;
+	}
+
+	/* Jump over everything until both lines are high, without reporting the edges in between. */
+	for ( ; ; ) {
+		if (mDataP->GetSampleNumber() < sample) {
+			mDataP->AdvanceToAbsPosition(sample);
+		}
+		if (mDataN->GetSampleNumber() < sample) {
+			mDataN->AdvanceToAbsPosition(sample);
+		}
+
+		/* Only a rising edge on a low line can bring LP-11 closer. */
+		if (mDataP->GetBitState() == BIT_LOW) {
+			AdvanceFiltered(mDataP);
+			sample = mDataP->GetSampleNumber();
+		} else if (mDataN->GetBitState() == BIT_LOW) {
+			AdvanceFiltered(mDataN);
+			sample = mDataN->GetSampleNumber();
+		} else {
+			break;
+		}
+	}
+
+	mSample = sample;
+	mState = LP_11;
+	mNextPKnown = false;
+	mNextNKnown = false;
+}
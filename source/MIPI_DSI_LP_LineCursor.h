@@ -0,0 +1,52 @@
+#ifndef MIPI_DSI_LP__LINE_CURSOR_H
+#define MIPI_DSI_LP__LINE_CURSOR_H
+
+#include <AnalyzerChannelData.h>
+
+/* LP line states: D+ in bit 1, D- in bit 0. */
+enum LineState
+{
+	LP_00 = 0,
+	LP_01 = 1,
+	LP_10 = 2,
+	LP_11 = 3
+};
+
+/* One change of the LP line state. */
+struct LineEvent
+{
+	U64 sample;		/* First sample of the new state. */
+	U64 duration;	/* How long the previous state lasted. */
+	U8 state;		/* New LP line state. */
+};
+
+/* Merges the D+ and D- edges into a single ordered stream of LP line states, with glitches filtered out. */
+class MIPI_DSI_LP_LineCursor
+{
+public:
+	MIPI_DSI_LP_LineCursor();
+
+	void Reset(AnalyzerChannelData* dataP, AnalyzerChannelData* dataN, U32 minPulseWidth);
+	void Next(LineEvent& event);
+	void SkipToStop(void);
+	bool GetNextSample(U64& sample);
+	bool WaitFor(U64 sample);
+	U64 GetHorizon(void) const;
+
+	U8 GetState() const { return mState; }
+	U64 GetSampleNumber() const { return mSample; }
+
+protected:
+	void Refresh(AnalyzerChannelData* data, U64& next, bool& known);
+	void AdvanceFiltered(AnalyzerChannelData* data);
+
+	AnalyzerChannelData *mDataP, *mDataN;
+	U64 mNextP, mNextN;			/* Sample of the next edge on each line, */
+	bool mNextPKnown, mNextNKnown;	/* once the line has been moved onto it. */
+	U64 mQuietP, mQuietN;		/* Each line is known to have no edge up to here. */
+	U64 mSample;				/* First sample of the current state. */
+	U8 mState;					/* Current LP line state. */
+	U32 mMinPulseWidth;			/* Shorter pulses on either line are glitches and ignored. */
+};
+
+#endif //MIPI_DSI_LP__LINE_CURSOR_H
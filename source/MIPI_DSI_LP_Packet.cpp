@@ -0,0 +1,222 @@
+#include "MIPI_DSI_LP_Packet.h"
+#include <stddef.h>
+
+/* Syndrome of every header bit D0..D23: the ECC bits P0..P5 it contributes to. */
+static constexpr U8 DSI_eccColumns[24] =
+{
+	0x07, 0x0B, 0x0D, 0x0E, 0x13, 0x15, 0x16, 0x19,	/* D0..D7 (DI) */
+	0x1A, 0x1C, 0x23, 0x25, 0x26, 0x29, 0x2A, 0x2C,	/* D8..D15 (data 0) */
+	0x31, 0x32, 0x34, 0x38, 0x1F, 0x2F, 0x37, 0x3B	/* D16..D23 (data 1) */
+};
+
+/* ECC lookup tables, built at compile time. */
+struct DSI_EccTables
+{
+	U8 parity[3][256];	/* ECC contribution of each header byte value. */
+	U8 syndrome[64];	/* Header bit to flip for a syndrome, or one of the DSI_ECC_SYNDROME_* codes. */
+
+	constexpr DSI_EccTables() : parity(), syndrome()
+	{
+		for (U32 byte = 0; byte < 3; byte++) {
+			for (U32 value = 0; value < 256; value++) {
+				U8 ecc = 0;
+				for (U32 bit = 0; bit < 8; bit++) {
+					if (value & (1U << bit)) ecc ^= DSI_eccColumns[8 * byte + bit];
+				}
+				parity[byte][value] = ecc;
+			}
+		}
+
+		/* Anything not listed below is a multi-bit error. */
+		for (U32 s = 0; s < 64; s++) syndrome[s] = DSI_ECC_SYNDROME_UNCORRECTABLE;
+		syndrome[0] = DSI_ECC_SYNDROME_NONE;
+		/* A single flipped ECC bit leaves the header intact. */
+		for (U32 bit = 0; bit < 6; bit++) syndrome[1U << bit] = DSI_ECC_SYNDROME_ECC_BIT;
+		/* A single flipped header bit. */
+		for (U32 bit = 0; bit < 24; bit++) syndrome[DSI_eccColumns[bit]] = U8(bit);
+	}
+};
+
+static constexpr DSI_EccTables DSI_ecc;
+
+U8 DSI_ComputeEcc(U32 header)
+{
+	return DSI_ecc.parity[0][header & 0xFF] ^ DSI_ecc.parity[1][(header >> 8) & 0xFF] ^ DSI_ecc.parity[2][(header >> 16) & 0xFF];
+}
+
+DSI_EccStatus DSI_CheckEcc(U32& header)
+{
+	U8 syndrome = (DSI_ComputeEcc(header) ^ (header >> 24)) & 0x3F;
+	U8 action = DSI_ecc.syndrome[syndrome];
+
+	switch (action) {
+	case DSI_ECC_SYNDROME_NONE:
+		return DSI_ECC_OK;
+	case DSI_ECC_SYNDROME_ECC_BIT:
+		/* Restore the ECC byte so the header reads back consistent. */
+		header ^= U32(syndrome) << 24;
+		return DSI_ECC_CORRECTED;
+	case DSI_ECC_SYNDROME_UNCORRECTABLE:
+		return DSI_ECC_ERROR;
+	default:
+		/* Single-bit error in DI or data: flip it back. */
+		header ^= 1U << action;
+		return DSI_ECC_CORRECTED;
+	}
+}
+
+U32 DSI_GetPacketHeader(const U8* bytes, U32 count)
+{
+	U32 header = 0;
+
+	for (U32 i = 0; (i < DSI_HEADER_LENGTH) && (i < count); i++) {
+		header |= U32(bytes[i]) << (8U * i);
+	}
+	/* Byte frames keep the header as it was received, so every exporter corrects it here on the way out. */
+	if (count >= DSI_HEADER_LENGTH) {
+		DSI_CheckEcc(header);
+	}
+	return header;
+}
+
+/* Data type tables, 64 entries per direction indexed by DT, built at compile time. */
+struct DSI_DataTypeTables
+{
+	DSI_DataTypeInfo host[64];
+	DSI_DataTypeInfo peripheral[64];
+
+	constexpr DSI_DataTypeTables() : host(), peripheral()
+	{
+		/* Anything not listed below stays undefined. */
+		for (U32 dt = 0; dt < 64; dt++) {
+			host[dt] = { NULL, -1, DSI_DT_CLASS_UNKNOWN };
+			peripheral[dt] = { NULL, -1, DSI_DT_CLASS_UNKNOWN };
+		}
+
+		host[0x01] = { "Sync Event, V Sync Start", -1, DSI_DT_CLASS_CONTROL };
+		host[0x11] = { "Sync Event, V Sync End", -1, DSI_DT_CLASS_CONTROL };
+		host[0x21] = { "Sync Event, H Sync Start", -1, DSI_DT_CLASS_CONTROL };
+		host[0x31] = { "Sync Event, H Sync End", -1, DSI_DT_CLASS_CONTROL };
+		host[0x07] = { "Compression Mode Command", -1, DSI_DT_CLASS_CONTROL };
+		host[0x08] = { "End of Transmission packet(EoTp)", -1, DSI_DT_CLASS_CONTROL };
+		host[0x02] = { "Color Mode(CM) Off Command", -1, DSI_DT_CLASS_CONTROL };
+		host[0x12] = { "Color Mode(CM) On Command", -1, DSI_DT_CLASS_CONTROL };
+		host[0x22] = { "Shut Down Peripheral Command", -1, DSI_DT_CLASS_CONTROL };
+		host[0x32] = { "Turn On Peripheral Command", -1, DSI_DT_CLASS_CONTROL };
+		host[0x03] = { "Generic Short WRITE", 0, DSI_DT_CLASS_WRITE };
+		host[0x13] = { "Generic Short WRITE", 1, DSI_DT_CLASS_WRITE };
+		host[0x23] = { "Generic Short WRITE", 2, DSI_DT_CLASS_WRITE };
+		host[0x04] = { "Generic READ", 0, DSI_DT_CLASS_READ };
+		host[0x14] = { "Generic READ", 1, DSI_DT_CLASS_READ };
+		host[0x24] = { "Generic READ", 2, DSI_DT_CLASS_READ };
+		host[0x05] = { "DCS Short WRITE", 0, DSI_DT_CLASS_WRITE };
+		host[0x15] = { "DCS Short WRITE", 1, DSI_DT_CLASS_WRITE };
+		host[0x06] = { "DCS READ", 0, DSI_DT_CLASS_READ };
+		host[0x16] = { "Execute Queue", -1, DSI_DT_CLASS_WRITE };
+		host[0x37] = { "Set Maximum Return Packet Size", -1, DSI_DT_CLASS_WRITE };
+		host[0x09] = { "Null Packet", -1, DSI_DT_CLASS_BLANKING };
+		host[0x19] = { "Blanking Packet", -1, DSI_DT_CLASS_BLANKING };
+		host[0x29] = { "Generic Long Write", -1, DSI_DT_CLASS_WRITE };
+		host[0x39] = { "DCS Long Write / write_LUT Command Packet", -1, DSI_DT_CLASS_WRITE };
+		host[0x0A] = { "Picture Parameter Set", -1, DSI_DT_CLASS_PIXELS };
+		host[0x0B] = { "Compressed Pixel Stream", -1, DSI_DT_CLASS_PIXELS };
+		host[0x0C] = { "Loosely Packed Pixel Stream, 20 - bit YCbCr, 4:2 : 2 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x1C] = { "Packed Pixel Stream, 24 - bit YCbCr, 4 : 2 : 2 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x2C] = { "Packed Pixel Stream, 16 - bit YCbCr, 4 : 2 : 2 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x0D] = { "Packed Pixel Stream, 30 - bit RGB, 10 - 10 - 10 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x1D] = { "Packed Pixel Stream, 36 - bit RGB, 12 - 12 - 12 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x3D] = { "Packed Pixel Stream, 12 - bit YCbCr, 4 : 2 : 0 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x0E] = { "Packed Pixel Stream, 16 - bit RGB, 5 - 6 - 5 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x1E] = { "Packed Pixel Stream, 18 - bit RGB, 6 - 6 - 6 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x2E] = { "Loosely Packed Pixel Stream, 18 - bit RGB, 6 - 6 - 6 Format", -1, DSI_DT_CLASS_PIXELS };
+		host[0x3E] = { "Packed Pixel Stream, 24 - bit RGB, 8 - 8 - 8 Format", -1, DSI_DT_CLASS_PIXELS };
+
+		peripheral[0x02] = { "Acknowledge and Error Report", -1, DSI_DT_CLASS_ACK };
+		peripheral[0x08] = { "End of Transmission packet(EoTp)", -1, DSI_DT_CLASS_CONTROL };
+		peripheral[0x11] = { "Generic Short READ Response", 1, DSI_DT_CLASS_RESPONSE };
+		peripheral[0x12] = { "Generic Short READ Response", 2, DSI_DT_CLASS_RESPONSE };
+		peripheral[0x1A] = { "Generic Long READ Response", -1, DSI_DT_CLASS_RESPONSE };
+		peripheral[0x1C] = { "DCS Long READ Response", -1, DSI_DT_CLASS_RESPONSE };
+		peripheral[0x21] = { "DCS Short READ Response", 1, DSI_DT_CLASS_RESPONSE };
+		peripheral[0x22] = { "DCS Short READ Response", 2, DSI_DT_CLASS_RESPONSE };
+	}
+};
+
+static constexpr DSI_DataTypeTables DSI_dataTypes;
+
+const DSI_DataTypeInfo& DSI_GetDataTypeInfo(U8 dt, bool reverse)
+{
+	return reverse ? DSI_dataTypes.peripheral[dt & 0x3F] : DSI_dataTypes.host[dt & 0x3F];
+}
+
+/* Entry command lookup, built at compile time. */
+struct DSI_EscapeTable
+{
+	U8 command[256];	/* DSI_EscapeCommand of every entry byte. */
+
+	constexpr DSI_EscapeTable() : command()
+	{
+		/* Anything not listed below is left as DSI_ESC_UNKNOWN. */
+		command[DSI_ENTRY_LPDT] = DSI_ESC_LPDT;
+		command[DSI_ENTRY_ULPS] = DSI_ESC_ULPS;
+		command[DSI_ENTRY_RESET] = DSI_ESC_RESET;
+		command[DSI_ENTRY_TEARING_EFFECT] = DSI_ESC_TEARING_EFFECT;
+		command[DSI_ENTRY_ACKNOWLEDGE] = DSI_ESC_ACKNOWLEDGE;
+		command[DSI_ENTRY_UNKNOWN_5] = DSI_ESC_UNKNOWN_5;
+	}
+};
+
+static constexpr DSI_EscapeTable DSI_escape;
+
+DSI_EscapeCommand DSI_DecodeEscapeCommand(U8 entry)
+{
+	return DSI_EscapeCommand(DSI_escape.command[entry]);
+}
+
+/* CRC-16/CCITT as used by DSI: polynomial x^16 + x^12 + x^5 + 1, LSB first (0x8408). */
+#define DSI_CRC_POLYNOMIAL	0x8408
+
+/* Slice-by-8 CRC tables, built at compile time. */
+struct DSI_CrcTables
+{
+	U16 slice[8][256];	/* slice[k][b]: CRC of byte b followed by k zero bytes. */
+
+	constexpr DSI_CrcTables() : slice()
+	{
+		for (U32 value = 0; value < 256; value++) {
+			U16 crc = U16(value);
+			for (U32 bit = 0; bit < 8; bit++) {
+				crc = (crc & 1) ? U16((crc >> 1) ^ DSI_CRC_POLYNOMIAL) : U16(crc >> 1);
+			}
+			slice[0][value] = crc;
+		}
+		for (U32 k = 1; k < 8; k++) {
+			for (U32 value = 0; value < 256; value++) {
+				slice[k][value] = U16((slice[k - 1][value] >> 8) ^ slice[0][slice[k - 1][value] & 0xFF]);
+			}
+		}
+	}
+};
+
+static constexpr DSI_CrcTables DSI_crc;
+
+U16 DSI_UpdateCrc(U16 crc, const U8* data, U32 length)
+{
+	/* Eight bytes per step. */
+	while (length >= 8) {
+		crc ^= U16(data[0] | (data[1] << 8));
+		crc = DSI_crc.slice[7][crc & 0xFF] ^ DSI_crc.slice[6][crc >> 8] ^
+			DSI_crc.slice[5][data[2]] ^ DSI_crc.slice[4][data[3]] ^
+			DSI_crc.slice[3][data[4]] ^ DSI_crc.slice[2][data[5]] ^
+			DSI_crc.slice[1][data[6]] ^ DSI_crc.slice[0][data[7]];
+		data += 8;
+		length -= 8;
+	}
+
+	/* Remaining bytes one at a time. */
+	while (length--) {
+		crc = U16((crc >> 8) ^ DSI_crc.slice[0][(crc ^ *data++) & 0xFF]);
+	}
+
+	return crc;
+}
@@ -0,0 +1,104 @@
+#ifndef MIPI_DSI_LP__PACKET_H
+#define MIPI_DSI_LP__PACKET_H
+
+#include <LogicPublicTypes.h>
+
+/* DSI packet layout. */
+#define DSI_HEADER_LENGTH		4U	/* DI, data 0 / WC LSB, data 1 / WC MSB, ECC. */
+#define DSI_FOOTER_LENGTH		2U	/* Checksum of a long packet. */
+
+/* Virtual Channel Field is DI[7:6]. */
+inline U8 DSI_GetVirtualChannel(U8 di)
+{
+	return (di >> 6) & 0x3;
+}
+
+/* Data Type Field is DI[5:0]. */
+inline U8 DSI_GetDataType(U8 di)
+{
+	return di & 0x3F;
+}
+
+/* Long packets are the data types with DT[3:0] between 0x9 and 0xE. */
+inline bool DSI_IsLongPacket(U8 di)
+{
+	U8 dt = di & 0x0F;
+	return (dt >= 0x9) && (dt <= 0xE);
+}
+
+/* What a data type is for, kept in a frame's mType. */
+enum DSI_DataTypeClass
+{
+	DSI_DT_CLASS_UNKNOWN = 0,	/* Not defined for this direction. */
+	DSI_DT_CLASS_CONTROL,		/* Sync events, EoTp, color mode, peripheral on/off, compression mode. */
+	DSI_DT_CLASS_WRITE,			/* Generic and DCS writes, execute queue, maximum return packet size. */
+	DSI_DT_CLASS_READ,			/* Generic and DCS READ requests. */
+	DSI_DT_CLASS_BLANKING,		/* Null and blanking packets. */
+	DSI_DT_CLASS_PIXELS,		/* Pixel streams and picture parameter set. */
+	DSI_DT_CLASS_RESPONSE,		/* Read responses from the peripheral. */
+	DSI_DT_CLASS_ACK			/* Acknowledge and error report from the peripheral. */
+};
+
+/* Everything known about a data type. */
+struct DSI_DataTypeInfo
+{
+	const char* description;	/* NULL if the data type is not defined. */
+	S8 parameters;				/* Parameters of a short packet, -1 if not applicable. */
+	U8 dtClass;					/* DSI_DataTypeClass. */
+};
+
+/* Data type lookup, by DT and direction (reverse: sent by the peripheral after a bus turnaround). */
+const DSI_DataTypeInfo& DSI_GetDataTypeInfo(U8 dt, bool reverse);
+
+/* Escape mode entry commands, first bit on the wire in bit 7. */
+#define DSI_ENTRY_LPDT				0xE1	/* Low-Power Data Transmission. */
+#define DSI_ENTRY_ULPS				0x1E	/* Ultra-Low Power State. */
+#define DSI_ENTRY_RESET				0x62	/* Remote Application Reset trigger. */
+#define DSI_ENTRY_TEARING_EFFECT	0x5D	/* Tearing Effect trigger (Unknown-3). */
+#define DSI_ENTRY_ACKNOWLEDGE		0x21	/* Acknowledge trigger (Unknown-4). */
+#define DSI_ENTRY_UNKNOWN_5			0xA0	/* Unknown-5 trigger. */
+
+/* What an entry command starts. */
+enum DSI_EscapeCommand
+{
+	DSI_ESC_UNKNOWN = 0,		/* Not a valid entry command. */
+	DSI_ESC_LPDT,
+	DSI_ESC_ULPS,
+	DSI_ESC_RESET,
+	DSI_ESC_TEARING_EFFECT,
+	DSI_ESC_ACKNOWLEDGE,
+	DSI_ESC_UNKNOWN_5,
+	DSI_ESC_PENDING			/* Entry command not fully received yet. */
+};
+
+/* Classify an entry command byte. */
+DSI_EscapeCommand DSI_DecodeEscapeCommand(U8 entry);
+
+/* Syndrome table entries other than a header bit index. */
+#define DSI_ECC_SYNDROME_NONE			0xFD
+#define DSI_ECC_SYNDROME_ECC_BIT		0xFE
+#define DSI_ECC_SYNDROME_UNCORRECTABLE	0xFF
+
+/* Outcome of a header ECC check. */
+enum DSI_EccStatus
+{
+	DSI_ECC_OK = 0,		/* Header is intact. */
+	DSI_ECC_CORRECTED,	/* Single-bit error, corrected. */
+	DSI_ECC_ERROR		/* Multi-bit error, header can't be trusted. */
+};
+
+/* ECC over the 24 header bits (DI, data 0, data 1 in the low three bytes). */
+U8 DSI_ComputeEcc(U32 header);
+/* Check a full 4-byte header (ECC in the top byte) and correct a single-bit error in place. */
+DSI_EccStatus DSI_CheckEcc(U32& header);
+/* Header of a packet from its first bytes, corrected when all four are in. Short of that, what arrived of it. */
+U32 DSI_GetPacketHeader(const U8* bytes, U32 count);
+
+/* Long packet checksum. A packet with no payload checksums to 0xFFFF, 0x0000 means "not calculated". */
+#define DSI_CRC_INIT			0xFFFF
+#define DSI_CRC_NOT_CALCULATED	0x0000
+
+/* Fold bytes into a running CRC-16/CCITT (start from DSI_CRC_INIT). */
+U16 DSI_UpdateCrc(U16 crc, const U8* data, U32 length);
+
+#endif //MIPI_DSI_LP__PACKET_H
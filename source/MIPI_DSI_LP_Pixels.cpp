@@ -0,0 +1,370 @@
+#include "MIPI_DSI_LP_Pixels.h"
+#include <string.h>
+
+/* SIMD kernels on x86, picked at run time. Define DSI_PIXELS_NO_SIMD to build the scalar kernels only. */
+#if !defined(DSI_PIXELS_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define DSI_PIXELS_SSE2
+#if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))))
+#define DSI_PIXELS_AVX2
+#endif
+#endif
+
+#ifdef DSI_PIXELS_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef DSI_PIXELS_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define DSI_TARGET_AVX2
+#else
+#define DSI_TARGET_AVX2		__attribute__((target("avx2")))
+#endif
+#endif
+
+/* Widens a component to 8 bits, repeating its top bits in the new low bits. */
+static inline U8 DSI_Expand(U32 value, U32 bits)
+{
+	return (bits >= 8) ? U8(value >> (bits - 8)) : U8((value << (8 - bits)) | (value >> (2 * bits - 8)));
+}
+
+/* Reads a field of up to 16 bits from an LSB first bit stream. */
+static inline U32 DSI_GetBits(const U8* data, U32 offset, U32 bits)
+{
+	const U8* p = &data[offset >> 3];
+	U32 shift = offset & 7;
+	U32 value = p[0];
+
+	if ((shift + bits) > 8) {
+		value |= U32(p[1]) << 8;
+	}
+	if ((shift + bits) > 16) {
+		value |= U32(p[2]) << 16;
+	}
+	return (value >> shift) & ((1U << bits) - 1);
+}
+
+/* YCbCr (BT.601, full range) to RGB888, in 16.16 fixed point. */
+static inline U8 DSI_Clamp(S32 value)
+{
+	return (value < 0) ? 0 : ((value > 255) ? 255 : U8(value));
+}
+
+static inline void DSI_YCbCrToRgb(S32 y, S32 cb, S32 cr, U8* rgb)
+{
+	cb -= 128;
+	cr -= 128;
+	rgb[0] = DSI_Clamp(y + ((91881 * cr) >> 16));
+	rgb[1] = DSI_Clamp(y - ((22554 * cb + 46802 * cr) >> 16));
+	rgb[2] = DSI_Clamp(y + ((116130 * cb) >> 16));
+}
+
+/* Scalar kernels, one per format. */
+
+static void DSI_UnpackRgb565(const U8* payload, U32 count, U8* rgb)
+{
+	for (U32 i = 0; i < count; i++) {
+		U32 word = payload[2 * i] | (U32(payload[2 * i + 1]) << 8);
+		rgb[3 * i + 0] = DSI_Expand(word & 0x1F, 5);
+		rgb[3 * i + 1] = DSI_Expand((word >> 5) & 0x3F, 6);
+		rgb[3 * i + 2] = DSI_Expand(word >> 11, 5);
+	}
+}
+
+static void DCS_UnpackRgb565(const U8* data, U32 count, U8* rgb)
+{
+	for (U32 i = 0; i < count; i++) {
+		U32 word = (U32(data[2 * i]) << 8) | data[2 * i + 1];
+		rgb[3 * i + 0] = DSI_Expand(word >> 11, 5);
+		rgb[3 * i + 1] = DSI_Expand((word >> 5) & 0x3F, 6);
+		rgb[3 * i + 2] = DSI_Expand(word & 0x1F, 5);
+	}
+}
+
+static void DSI_UnpackRgb666Loose(const U8* payload, U32 length, U8* rgb)
+{
+	for (U32 i = 0; i < length; i++) {
+		rgb[i] = (payload[i] & 0xFC) | (payload[i] >> 6);
+	}
+}
+
+/* Packed RGB with the same number of bits per component. */
+static void DSI_UnpackRgbPacked(const U8* payload, U32 count, U32 bits, U8* rgb)
+{
+	U32 offset = 0;
+
+	for (U32 i = 0; i < (3 * count); i++) {
+		rgb[i] = DSI_Expand(DSI_GetBits(payload, offset, bits), bits);
+		offset += bits;
+	}
+}
+
+/* YCbCr 4:2:2, two pixels per Cb, Y0, Cr, Y1 group of fields in a bit stream. Values sit in the upper bits of their field. */
+static void DSI_UnpackYCbCr422(const U8* payload, U32 count, U32 fieldBits, U8* rgb)
+{
+	U32 offset = 0;
+	U32 drop = fieldBits - 8;
+
+	for (U32 i = 0; (i + 1) < count; i += 2) {
+		S32 cb = S32(DSI_GetBits(payload, offset, fieldBits) >> drop);
+		S32 y0 = S32(DSI_GetBits(payload, offset + fieldBits, fieldBits) >> drop);
+		S32 cr = S32(DSI_GetBits(payload, offset + 2 * fieldBits, fieldBits) >> drop);
+		S32 y1 = S32(DSI_GetBits(payload, offset + 3 * fieldBits, fieldBits) >> drop);
+
+		DSI_YCbCrToRgb(y0, cb, cr, &rgb[3 * i]);
+		DSI_YCbCrToRgb(y1, cb, cr, &rgb[3 * (i + 1)]);
+		offset += 4 * fieldBits;
+	}
+}
+
+#ifdef DSI_PIXELS_SSE2
+/* Compacts four R, G, B, 0 pixels into the low 12 bytes. */
+static inline __m128i DSI_PackRgbx(__m128i rgbx)
+{
+	const __m128i low = _mm_set1_epi64x(0x0000000000FFFFFFLL);
+	const __m128i high = _mm_set1_epi64x(0x0000FFFFFF000000LL);
+
+	/* Two pixels per 64-bit lane into 6 bytes, then the second lane right behind the first. */
+	__m128i packed = _mm_or_si128(_mm_and_si128(rgbx, low), _mm_and_si128(_mm_srli_epi64(rgbx, 8), high));
+	return _mm_or_si128(_mm_move_epi64(packed), _mm_slli_si128(_mm_srli_si128(packed, 8), 6));
+}
+
+/* Eight pixels a step. Every store writes 4 bytes past its pixels, the next pixels overwrite them. */
+static U32 DSI_UnpackRgb565Sse2(const U8* payload, U32 count, U8* rgb)
+{
+	const __m128i mask5 = _mm_set1_epi16(0x1F);
+	const __m128i mask6 = _mm_set1_epi16(0x3F);
+	U32 i = 0;
+
+	for (; (i + 8 + 2) <= count; i += 8) {
+		__m128i word = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&payload[2 * i]));
+		__m128i r = _mm_and_si128(word, mask5);
+		__m128i g = _mm_and_si128(_mm_srli_epi16(word, 5), mask6);
+		__m128i b = _mm_srli_epi16(word, 11);
+
+		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+		g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+		__m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&rgb[3 * i]), DSI_PackRgbx(_mm_unpacklo_epi16(rg, b)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&rgb[3 * i + 12]), DSI_PackRgbx(_mm_unpackhi_epi16(rg, b)));
+	}
+	return i;
+}
+
+static U32 DSI_UnpackRgb666LooseSse2(const U8* payload, U32 length, U8* rgb)
+{
+	const __m128i top = _mm_set1_epi8(S8(0xFC));
+	const __m128i bottom = _mm_set1_epi8(0x03);
+	U32 i = 0;
+
+	for (; (i + 16) <= length; i += 16) {
+		__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&payload[i]));
+		/* The 16-bit shift pulls in bits of the next byte, the mask drops them again. */
+		__m128i result = _mm_or_si128(_mm_and_si128(value, top), _mm_and_si128(_mm_srli_epi16(value, 6), bottom));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&rgb[i]), result);
+	}
+	return i;
+}
+#endif
+
+#ifdef DSI_PIXELS_AVX2
+/* Sixteen pixels a step, compacted within each 128-bit lane. */
+DSI_TARGET_AVX2 static U32 DSI_UnpackRgb565Avx2(const U8* payload, U32 count, U8* rgb)
+{
+	const __m256i mask5 = _mm256_set1_epi16(0x1F);
+	const __m256i mask6 = _mm256_set1_epi16(0x3F);
+	const __m256i compact = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	U32 i = 0;
+
+	for (; (i + 16 + 2) <= count; i += 16) {
+		__m256i word = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&payload[2 * i]));
+		__m256i r = _mm256_and_si256(word, mask5);
+		__m256i g = _mm256_and_si256(_mm256_srli_epi16(word, 5), mask6);
+		__m256i b = _mm256_srli_epi16(word, 11);
+
+		r = _mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2));
+		g = _mm256_or_si256(_mm256_slli_epi16(g, 2), _mm256_srli_epi16(g, 4));
+		b = _mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2));
+
+		/* Pixels 0-3 and 8-11 in lo, 4-7 and 12-15 in hi. */
+		__m256i rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+		__m256i lo = _mm256_shuffle_epi8(_mm256_unpacklo_epi16(rg, b), compact);
+		__m256i hi = _mm256_shuffle_epi8(_mm256_unpackhi_epi16(rg, b), compact);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&rgb[3 * i]), _mm256_castsi256_si128(lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&rgb[3 * i + 12]), _mm256_castsi256_si128(hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&rgb[3 * i + 24]), _mm256_extracti128_si256(lo, 1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&rgb[3 * i + 36]), _mm256_extracti128_si256(hi, 1));
+	}
+	return i;
+}
+
+DSI_TARGET_AVX2 static U32 DSI_UnpackRgb666LooseAvx2(const U8* payload, U32 length, U8* rgb)
+{
+	const __m256i top = _mm256_set1_epi8(S8(0xFC));
+	const __m256i bottom = _mm256_set1_epi8(0x03);
+	U32 i = 0;
+
+	for (; (i + 32) <= length; i += 32) {
+		__m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&payload[i]));
+		__m256i result = _mm256_or_si256(_mm256_and_si256(value, top), _mm256_and_si256(_mm256_srli_epi16(value, 6), bottom));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&rgb[i]), result);
+	}
+	return i;
+}
+
+/* AVX2 needs the CPU to have it and the OS to save the YMM registers. */
+static bool DSI_HasAvx2(void)
+{
+#ifdef _MSC_VER
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 27)) || ((_xgetbv(0) & 6) != 6)) {
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+/* Kernels picked for this CPU, once. */
+struct DSI_PixelKernels
+{
+	U32 (*rgb565)(const U8* payload, U32 count, U8* rgb);
+	U32 (*rgb666Loose)(const U8* payload, U32 length, U8* rgb);
+
+	DSI_PixelKernels() : rgb565(NULL), rgb666Loose(NULL)
+	{
+#ifdef DSI_PIXELS_SSE2
+		rgb565 = DSI_UnpackRgb565Sse2;
+		rgb666Loose = DSI_UnpackRgb666LooseSse2;
+#endif
+#ifdef DSI_PIXELS_AVX2
+		if (DSI_HasAvx2()) {
+			rgb565 = DSI_UnpackRgb565Avx2;
+			rgb666Loose = DSI_UnpackRgb666LooseAvx2;
+		}
+#endif
+	}
+};
+
+static const DSI_PixelKernels& DSI_GetPixelKernels(void)
+{
+	static const DSI_PixelKernels kernels;
+	return kernels;
+}
+
+U32 DSI_GetPixelCount(U8 dt, U32 length)
+{
+	switch (dt) {
+	case DSI_DT_RGB565:
+		return length / 2;
+	case DSI_DT_RGB666:
+		return (length * 8) / 18;
+	case DSI_DT_RGB666_LOOSE:
+	case DSI_DT_RGB888:
+		return length / 3;
+	case DSI_DT_RGB101010:
+		return (length * 8) / 30;
+	case DSI_DT_RGB121212:
+		return (length * 8) / 36;
+	case DSI_DT_YCBCR422_16:
+		return (length / 4) * 2;
+	case DSI_DT_YCBCR422_20_LOOSE:
+	case DSI_DT_YCBCR422_24:
+		return (length / 6) * 2;
+	default:
+		return 0;
+	}
+}
+
+U32 DSI_UnpackPixels(U8 dt, const U8* payload, U32 length, U8* rgb)
+{
+	const DSI_PixelKernels& kernels = DSI_GetPixelKernels();
+	U32 count = DSI_GetPixelCount(dt, length);
+	U32 done = 0;
+
+	switch (dt) {
+	case DSI_DT_RGB565:
+		/* The SIMD kernel does the bulk, the scalar one the rest. */
+		if (kernels.rgb565 != NULL) {
+			done = kernels.rgb565(payload, count, rgb);
+		}
+		DSI_UnpackRgb565(&payload[2 * done], count - done, &rgb[3 * done]);
+		break;
+	case DSI_DT_RGB666_LOOSE:
+		if (kernels.rgb666Loose != NULL) {
+			done = kernels.rgb666Loose(payload, 3 * count, rgb);
+		}
+		DSI_UnpackRgb666Loose(&payload[done], 3 * count - done, &rgb[done]);
+		break;
+	case DSI_DT_RGB888:
+		memcpy(rgb, payload, 3 * count);
+		break;
+	case DSI_DT_RGB666:
+		DSI_UnpackRgbPacked(payload, count, 6, rgb);
+		break;
+	case DSI_DT_RGB101010:
+		DSI_UnpackRgbPacked(payload, count, 10, rgb);
+		break;
+	case DSI_DT_RGB121212:
+		DSI_UnpackRgbPacked(payload, count, 12, rgb);
+		break;
+	case DSI_DT_YCBCR422_16:
+		DSI_UnpackYCbCr422(payload, count, 8, rgb);
+		break;
+	case DSI_DT_YCBCR422_20_LOOSE:
+		DSI_UnpackYCbCr422(payload, count, 12, rgb);
+		break;
+	case DSI_DT_YCBCR422_24:
+		DSI_UnpackYCbCr422(payload, count, 12, rgb);
+		break;
+	default:
+		break;
+	}
+	return count;
+}
+
+U32 DCS_GetPixelLength(U8 pixelFormat)
+{
+	switch (pixelFormat & 0x7) {
+	case DCS_PIXEL_FORMAT_16BPP:
+		return 2;
+	case DCS_PIXEL_FORMAT_18BPP:
+	case DCS_PIXEL_FORMAT_24BPP:
+		return 3;
+	default:
+		return 0;
+	}
+}
+
+U32 DCS_UnpackPixels(U8 pixelFormat, const U8* data, U32 length, U8* rgb)
+{
+	U32 pixelLength = DCS_GetPixelLength(pixelFormat);
+	U32 count;
+
+	switch (pixelFormat & 0x7) {
+	case DCS_PIXEL_FORMAT_16BPP:
+		count = length / pixelLength;
+		DCS_UnpackRgb565(data, count, rgb);
+		return count;
+	case DCS_PIXEL_FORMAT_18BPP:
+		/* Same layout as the loosely packed pixel stream. */
+		return DSI_UnpackPixels(DSI_DT_RGB666_LOOSE, data, length - (length % pixelLength), rgb);
+	case DCS_PIXEL_FORMAT_24BPP:
+		return DSI_UnpackPixels(DSI_DT_RGB888, data, length - (length % pixelLength), rgb);
+	default:
+		return 0;
+	}
+}
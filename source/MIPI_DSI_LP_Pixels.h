@@ -0,0 +1,43 @@
+#ifndef MIPI_DSI_LP__PIXELS_H
+#define MIPI_DSI_LP__PIXELS_H
+
+#include <LogicPublicTypes.h>
+
+/* Bytes per pixel of the unpacked RGB888 rows: R, G, B. */
+#define DSI_RGB_PIXEL_LENGTH	3U
+
+/* Pixel stream data types that unpack to RGB888. Packed formats are a bit stream, LSB first,
+   with the components of every pixel in R, G, B order; byte formats send R, G, B bytes. */
+#define DSI_DT_YCBCR422_20_LOOSE	0x0C	/* Cb, Y0, Cr, Y1: 10 bits in the upper bits of 12. */
+#define DSI_DT_YCBCR422_24			0x1C	/* Cb, Y0, Cr, Y1: 12 bits each. */
+#define DSI_DT_YCBCR422_16			0x2C	/* Cb, Y0, Cr, Y1: 8 bits each. */
+#define DSI_DT_RGB101010			0x0D
+#define DSI_DT_RGB121212			0x1D
+#define DSI_DT_RGB565				0x0E
+#define DSI_DT_RGB666				0x1E
+#define DSI_DT_RGB666_LOOSE			0x2E	/* Each component in the upper 6 bits of a byte. */
+#define DSI_DT_RGB888				0x3E
+
+/* Pixels in a payload of the given length, 0 if the data type doesn't unpack to RGB888. */
+U32 DSI_GetPixelCount(U8 dt, U32 length);
+
+/* Unpacks a pixel stream payload into RGB888, DSI_GetPixelCount() pixels. Returns the number of pixels written.
+   Uses SSE2 or AVX2 kernels where the CPU has them. */
+U32 DSI_UnpackPixels(U8 dt, const U8* payload, U32 length, U8* rgb);
+
+/* DCS pixel formats, set_pixel_format (COLMOD) bits [2:0]. DCS memory writes send R, G, B:
+   16 bpp as a big-endian RGB565 word, 18 bpp with each component in the upper 6 bits of a byte. */
+#define DCS_PIXEL_FORMAT_16BPP		0x5
+#define DCS_PIXEL_FORMAT_18BPP		0x6
+#define DCS_PIXEL_FORMAT_24BPP		0x7
+
+/* Longest DCS pixel, bytes. */
+#define DCS_MAX_PIXEL_LENGTH		3U
+
+/* Bytes per pixel of a DCS pixel format, 0 if it isn't one that unpacks to RGB888. */
+U32 DCS_GetPixelLength(U8 pixelFormat);
+
+/* Unpacks DCS memory write data into RGB888, whole pixels only. Returns the number of pixels written. */
+U32 DCS_UnpackPixels(U8 pixelFormat, const U8* data, U32 length, U8* rgb);
+
+#endif //MIPI_DSI_LP__PIXELS_H
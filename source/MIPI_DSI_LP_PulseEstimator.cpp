@@ -0,0 +1,68 @@
+#include "MIPI_DSI_LP_PulseEstimator.h"
+#include <string.h>
+
+MIPI_DSI_LP_PulseEstimator::MIPI_DSI_LP_PulseEstimator()
+{
+	Reset(5);
+}
+
+void MIPI_DSI_LP_PulseEstimator::Reset(U32 timeoutRatio)
+{
+	mTimeoutRatio = timeoutRatio;
+	mAverage = 0;
+	ClearRejects();
+	Update();
+}
+
+void MIPI_DSI_LP_PulseEstimator::Seed(U64 length)
+{
+	/* Start over from a single pulse. */
+	mAverage = ((length > 0) ? length : 1) << PULSE_AVERAGE_SHIFT;
+	ClearRejects();
+	Update();
+}
+
+void MIPI_DSI_LP_PulseEstimator::Add(U64 length)
+{
+	U64 average = GetLength();
+
+	/* Pulses within half to twice the average refine it. */
+	if ((length >= (average >> 1)) && (length <= (average << 1))) {
+		U64 scaled = length << PULSE_AVERAGE_SHIFT;
+
+		if (scaled >= mAverage) {
+			mAverage += (scaled - mAverage) >> PULSE_WEIGHT_SHIFT;
+		} else {
+			mAverage -= (mAverage - scaled) >> PULSE_WEIGHT_SHIFT;
+		}
+		Update();
+
+		/* A good pulse ends any run of outliers. */
+		if (mRejects > 0) {
+			ClearRejects();
+		}
+		return;
+	}
+
+	/* Anything else is a glitch or a stretched pulse, unless enough of them agree: then the bit rate changed. */
+	U32 bucket = 0;
+	for (U64 l = length; l > 1; l >>= 1) bucket++;
+
+	mRejects++;
+	mRejectSum[bucket] += length;
+	if (++mRejectCount[bucket] >= PULSE_RESEED_COUNT) {
+		Seed(mRejectSum[bucket] / mRejectCount[bucket]);
+	}
+}
+
+void MIPI_DSI_LP_PulseEstimator::ClearRejects()
+{
+	memset(mRejectCount, 0, sizeof(mRejectCount));
+	memset(mRejectSum, 0, sizeof(mRejectSum));
+	mRejects = 0;
+}
+
+void MIPI_DSI_LP_PulseEstimator::Update()
+{
+	mTimeout = GetLength() * mTimeoutRatio;
+}
@@ -0,0 +1,40 @@
+#ifndef MIPI_DSI_LP__PULSE_ESTIMATOR_H
+#define MIPI_DSI_LP__PULSE_ESTIMATOR_H
+
+#include <LogicPublicTypes.h>
+
+/* Running estimate of the LP pulse length (TLPX, one line state within a bit), and the timeout derived from it. */
+class MIPI_DSI_LP_PulseEstimator
+{
+public:
+	MIPI_DSI_LP_PulseEstimator();
+
+	void Reset(U32 timeoutRatio);
+	void Seed(U64 length);
+	void Add(U64 length);
+
+	bool IsSeeded() const { return mAverage != 0; }
+	U64 GetLength() const { return mAverage >> PULSE_AVERAGE_SHIFT; }
+	U64 GetTimeout() const { return mTimeout; }
+
+protected:
+	void Update(void);
+	void ClearRejects(void);
+
+	/* Average is kept in 1/2^PULSE_AVERAGE_SHIFT samples, each new pulse weighs 1/2^PULSE_WEIGHT_SHIFT. */
+	static const U32 PULSE_AVERAGE_SHIFT = 4;
+	static const U32 PULSE_WEIGHT_SHIFT = 3;
+	/* Pulses rejected in a row with the same order of magnitude before the estimate follows them. */
+	static const U32 PULSE_RESEED_COUNT = 8;
+
+	U64 mAverage;		/* Fixed point average pulse length, 0 until seeded. */
+	U64 mTimeout;		/* Samples a line state may last before the burst is given up. */
+	U32 mTimeoutRatio;	/* Timeout in pulse lengths. */
+
+	/* Pulses too far off the average, by log2 of their length. */
+	U32 mRejectCount[64];
+	U64 mRejectSum[64];
+	U32 mRejects;		/* Outliers since the last good pulse. */
+};
+
+#endif //MIPI_DSI_LP__PULSE_ESTIMATOR_H
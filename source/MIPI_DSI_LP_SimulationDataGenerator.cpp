@@ -1,8 +1,49 @@
 #include "MIPI_DSI_LP_SimulationDataGenerator.h"
 #include "MIPI_DSI_LP_AnalyzerSettings.h"
+#include "MIPI_DSI_LP_LineCursor.h"
+#include "MIPI_DSI_LP_Packet.h"
 
 #include <AnalyzerHelpers.h>
 
+/* Data types the simulation picks from. Short packet parameters follow the data type table. */
+static const U8 simShortTypes[] =
+{
+	0x01,	/* V Sync Start */
+	0x21,	/* H Sync Start */
+	0x03,	/* Generic Short WRITE, no parameters */
+	0x13,	/* Generic Short WRITE, 1 parameter */
+	0x23,	/* Generic Short WRITE, 2 parameters */
+	0x05,	/* DCS Short WRITE, no parameters */
+	0x15,	/* DCS Short WRITE, 1 parameter */
+	0x37	/* Set Maximum Return Packet Size */
+};
+
+static const U8 simLongTypes[] =
+{
+	0x09,	/* Null Packet */
+	0x29,	/* Generic Long Write */
+	0x39,	/* DCS Long Write */
+	0x0E,	/* Packed Pixel Stream, 16-bit RGB565 */
+	0x3E	/* Packed Pixel Stream, 24-bit RGB888 */
+};
+
+/* Line state time before the first burst and the seed of the packet generator. */
+#define SIM_START_BITS		10U
+#define SIM_RANDOM_SEED		0x2545F491U
+
+/* Bit index of a fault that doesn't happen in this burst. */
+#define SIM_NO_FAULT		0xFFFFFFFFU
+
+/* Ways an escape mode entry goes wrong. */
+enum SimEntryFault
+{
+	SIM_ENTRY_OK = 0,
+	SIM_ENTRY_LONG_BRIDGE,	/* LP-00 bridge past the decoder timeout. */
+	SIM_ENTRY_DP_HIGH,		/* D+ goes high during the entry pulse on D-. */
+	SIM_ENTRY_COMMAND,		/* Entry command with a bit flipped. */
+	SIM_ENTRY_COUNT
+};
+
 MIPI_DSI_LP_SimulationDataGenerator::MIPI_DSI_LP_SimulationDataGenerator()
 {
 }
@@ -16,8 +57,26 @@ void MIPI_DSI_LP_SimulationDataGenerator::Initialize( U32 simulation_sample_rate
 	mSimulationSampleRateHz = simulation_sample_rate;
 	mSettings = settings;
 
-	mSimulationChannelDataP = mSimulationChannels.Add(settings->mPosChannel, simulation_sample_rate, BIT_HIGH);
-	mSimulationChannelDataN = mSimulationChannels.Add(settings->mNegChannel, simulation_sample_rate, BIT_HIGH);
+	/* A bit is a mark and a space, each one pulse long. */
+	mPulseSamples = U32(U64(simulation_sample_rate) / (U64(settings->mSimBitRate) * 2000U));
+	if (mPulseSamples == 0) {
+		mPulseSamples = 1;
+	}
+	mIdleSamples = U64(settings->mSimIdleGap) * mPulseSamples * 2U;
+	/* Twice the timeout, so it is caught however the decoder's estimate drifts. */
+	mStretchSamples = U64(settings->mTimeoutRatio) * mPulseSamples * 2U;
+	mGlitchSamples = (mPulseSamples >= 4U) ? (mPulseSamples / 4U) : 1U;
+	/* xorshift32 must not start from 0. */
+	mRandomState = SIM_RANDOM_SEED ^ settings->mSimSeed;
+	if (mRandomState == 0) {
+		mRandomState = SIM_RANDOM_SEED;
+	}
+	mPacket.reserve(DSI_HEADER_LENGTH + settings->mSimPayloadLength + DSI_FOOTER_LENGTH);
+
+	/* Lines start in the stop state. */
+	mSimulationChannelDataP = mSimulationChannels.Add(settings->mPosChannel[0], simulation_sample_rate, BIT_HIGH);
+	mSimulationChannelDataN = mSimulationChannels.Add(settings->mNegChannel[0], simulation_sample_rate, BIT_HIGH);
+	CreateLines(LP_11, U64(SIM_START_BITS) * mPulseSamples * 2U);
 }
 
 U32 MIPI_DSI_LP_SimulationDataGenerator::GenerateSimulationData( U64 largest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channels )
@@ -26,16 +85,168 @@ U32 MIPI_DSI_LP_SimulationDataGenerator::GenerateSimulationData( U64 largest_sam
 
 	while (mSimulationChannelDataP->GetCurrentSampleNumber() < adjusted_largest_sample_requested)
 	{
-		//CreateSerialByte();
-		U32 samples_per_bit = mSimulationSampleRateHz / 1000000U;
-
-		mSimulationChannels.AdvanceAll(samples_per_bit * 10U);
-		//mSimulationChannelDataP->Transition();
-		//mSimulationChannelDataN->Transition();
-		//mSimulationChannels.AdvanceAll(samples_per_bit * 10U);
+		CreatePacket();
+		CreateBurst(DSI_ENTRY_LPDT, &mPacket[0], U32(mPacket.size()));
+		CreateLines(LP_11, mIdleSamples);
 	}
 
 	*simulation_channels = mSimulationChannels.GetArray();
 	return mSimulationChannels.GetCount();
 }
 
+void MIPI_DSI_LP_SimulationDataGenerator::CreatePacket(void)
+{
+	U32 header;
+
+	mPacket.clear();
+
+	if ((Random() % 100U) < mSettings->mSimLongPackets) {
+		U8 dt = simLongTypes[Random() % (sizeof(simLongTypes) / sizeof(simLongTypes[0]))];
+		U32 length = 1U + (Random() % mSettings->mSimPayloadLength);
+
+		/* Pixel streams carry whole pixels. */
+		if (dt == 0x0E) {
+			length = (length < 2U) ? 2U : (length & ~1U);
+		} else if (dt == 0x3E) {
+			length = (length < 3U) ? 3U : (length - (length % 3U));
+		}
+		length &= 0xFFFF;
+
+		header = dt | (length << 8);
+		header |= U32(DSI_ComputeEcc(header)) << 24;
+		for (U32 i = 0; i < DSI_HEADER_LENGTH; i++) {
+			mPacket.push_back(U8(header >> (8 * i)));
+		}
+		for (U32 i = 0; i < length; i++) {
+			mPacket.push_back(U8(Random()));
+		}
+		U16 crc = DSI_UpdateCrc(DSI_CRC_INIT, &mPacket[DSI_HEADER_LENGTH], length);
+		mPacket.push_back(U8(crc));
+		mPacket.push_back(U8(crc >> 8));
+	} else {
+		U8 dt = simShortTypes[Random() % (sizeof(simShortTypes) / sizeof(simShortTypes[0]))];
+		const DSI_DataTypeInfo& info = DSI_GetDataTypeInfo(dt, false);
+		U32 data = Random();
+
+		/* Unused data bytes are sent as 0, sync events have none. */
+		if (info.dtClass == DSI_DT_CLASS_CONTROL) {
+			data = 0;
+		} else if ((info.parameters >= 0) && (info.parameters < 2)) {
+			data &= (info.parameters == 1) ? 0x00FF : 0x0000;
+		}
+
+		header = dt | ((data & 0xFFFF) << 8);
+		header |= U32(DSI_ComputeEcc(header)) << 24;
+		for (U32 i = 0; i < DSI_HEADER_LENGTH; i++) {
+			mPacket.push_back(U8(header >> (8 * i)));
+		}
+	}
+}
+
+void MIPI_DSI_LP_SimulationDataGenerator::CreateBurst(U8 entry, const U8* data, U32 length)
+{
+	U32 bits = length * 8U;
+	U32 bitCount = bits;
+	U32 glitchBit = SIM_NO_FAULT, stretchBit = SIM_NO_FAULT, contentionBit = SIM_NO_FAULT;
+	U32 entryFault = SIM_ENTRY_OK;
+	bool failedStop = false;
+
+	/* Pick this burst's faults. Nothing is drawn for faults that are off, so clean traffic doesn't depend on them. */
+	if (Roll(SIM_FAULT_GLITCH)) {
+		glitchBit = Random() % bits;
+	}
+	if (Roll(SIM_FAULT_STRETCH)) {
+		stretchBit = Random() % bits;
+	}
+	if (Roll(SIM_FAULT_TRUNCATE)) {
+		bitCount = Random() % bits;
+	}
+	if (Roll(SIM_FAULT_ENTRY)) {
+		entryFault = SIM_ENTRY_OK + 1U + (Random() % (SIM_ENTRY_COUNT - 1U));
+	}
+	if (Roll(SIM_FAULT_CONTENTION)) {
+		/* Half the time the lines collide during a space, else the stop starts on the wrong line. */
+		if (Random() & 1U) {
+			contentionBit = Random() % bits;
+		} else {
+			failedStop = true;
+		}
+	}
+
+	/* Escape mode entry: LP-11 -> LP-10 -> LP-00 -> LP-01 -> LP-00. */
+	CreateLines(LP_10, mPulseSamples);
+	CreateLines(LP_00, (entryFault == SIM_ENTRY_LONG_BRIDGE) ? mStretchSamples : mPulseSamples);
+	CreateLines(LP_01, mPulseSamples);
+	if (entryFault == SIM_ENTRY_DP_HIGH) {
+		/* Both lines high: the burst is over before it started. */
+		CreateLines(LP_11, mPulseSamples);
+		return;
+	}
+	CreateLines(LP_00, mPulseSamples);
+
+	/* Spaced-one-hot bits: a mark on D+ for one, on D- for zero, then a space. Entry command first bit first. */
+	if (entryFault == SIM_ENTRY_COMMAND) {
+		entry ^= U8(1U << (Random() % 8U));
+	}
+	for (U32 i = 8; i-- > 0; ) {
+		CreateLines(((entry >> i) & 1U) ? LP_10 : LP_01, mPulseSamples);
+		CreateLines(LP_00, mPulseSamples);
+	}
+
+	/* Data bytes LSB first. */
+	for (U32 i = 0; i < bitCount; i++) {
+		if (i == contentionBit) {
+			/* Both lines pulled high out of the space. */
+			CreateLines(LP_11, mPulseSamples);
+			return;
+		}
+		CreateLines(((data[i >> 3] >> (i & 7U)) & 1U) ? LP_10 : LP_01, (i == stretchBit) ? mStretchSamples : mPulseSamples);
+		CreateSpace(i == glitchBit);
+	}
+
+	/* Stop: LP-10 -> LP-11, or LP-01 -> LP-11 when it fails. */
+	CreateLines(failedStop ? LP_01 : LP_10, mPulseSamples);
+	CreateLines(LP_11, mPulseSamples);
+}
+
+void MIPI_DSI_LP_SimulationDataGenerator::CreateSpace(bool glitch)
+{
+	if (!glitch) {
+		CreateLines(LP_00, mPulseSamples);
+		return;
+	}
+
+	/* A short pulse on either line in the middle of the space, never on the same sample as another edge. */
+	U32 half = (mPulseSamples >= 2U) ? (mPulseSamples / 2U) : 1U;
+	CreateLines(LP_00, half);
+	CreateLines((Random() & 1U) ? LP_10 : LP_01, mGlitchSamples);
+	CreateLines(LP_00, (mPulseSamples > half) ? (mPulseSamples - half) : 1U);
+}
+
+void MIPI_DSI_LP_SimulationDataGenerator::CreateLines(U8 state, U64 samples)
+{
+	mSimulationChannelDataP->TransitionIfNeeded((state & LP_10) ? BIT_HIGH : BIT_LOW);
+	mSimulationChannelDataN->TransitionIfNeeded((state & LP_01) ? BIT_HIGH : BIT_LOW);
+
+	/* Long stretches in as few steps as the descriptors allow. */
+	while (samples > 0xFFFFFFFFULL) {
+		mSimulationChannels.AdvanceAll(0xFFFFFFFFU);
+		samples -= 0xFFFFFFFFULL;
+	}
+	mSimulationChannels.AdvanceAll(U32(samples));
+}
+
+bool MIPI_DSI_LP_SimulationDataGenerator::Roll(U32 fault)
+{
+	U32 rate = mSettings->mSimFaultRate[fault];
+	return (rate > 0) && ((Random() % 1000U) < rate);
+}
+
+U32 MIPI_DSI_LP_SimulationDataGenerator::Random(void)
+{
+	/* xorshift32: fast and the same sequence on every platform. */
+	mRandomState ^= mRandomState << 13;
+	mRandomState ^= mRandomState >> 17;
+	mRandomState ^= mRandomState << 5;
+	return mRandomState;
+}
@@ -4,9 +4,12 @@
 #include <AnalyzerHelpers.h>
 #include <SimulationChannelDescriptor.h>
 #include <string>
+#include <vector>
 #include <stdlib.h>
 #include "MIPI_DSI_LP_AnalyzerSettings.h"
 
+/* Generates escape mode LPDT traffic on lane 0: one random short or long packet per burst, with valid ECC and checksum.
+   Faults are injected into bursts at the rates set in the settings. */
 class MIPI_DSI_LP_SimulationDataGenerator
 {
 public:
@@ -16,10 +19,25 @@ public:
 	void Initialize( U32 simulation_sample_rate, MIPI_DSI_LP_AnalyzerSettings* settings );
 	U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channels );
 
+protected:
+	void CreatePacket(void);
+	void CreateBurst(U8 entry, const U8* data, U32 length);
+	void CreateSpace(bool glitch);
+	void CreateLines(U8 state, U64 samples);
+	bool Roll(U32 fault);
+	U32 Random(void);
+
 protected:
 	MIPI_DSI_LP_AnalyzerSettings* mSettings;
 	U32 mSimulationSampleRateHz;
 
+	U32 mPulseSamples;			/* Samples per line state, half a bit period. */
+	U64 mIdleSamples;			/* Samples of LP-11 between bursts. */
+	U64 mStretchSamples;		/* Samples of a line state held past the decoder timeout. */
+	U32 mGlitchSamples;			/* Samples of a glitch. */
+	U32 mRandomState;			/* xorshift32 state. */
+	std::vector<U8> mPacket;	/* Bytes of the packet being sent. */
+
 protected:
 
 	SimulationChannelDescriptorGroup mSimulationChannels;
@@ -27,4 +45,4 @@ protected:
 	SimulationChannelDescriptor* mSimulationChannelDataN;
 
 };
-#endif //MIPI_DSI_LP__SIMULATION_DATA_GENERATOR
\ No newline at end of file
+#endif //MIPI_DSI_LP__SIMULATION_DATA_GENERATOR